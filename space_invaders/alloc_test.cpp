@@ -0,0 +1,65 @@
+// Headless check that the simulation stops allocating once warmed up.
+//
+// Plays a few seeds with the bot and counts heap allocations (through
+// alloc_tracker.cpp) around every handleInput + update after a warmup.
+// Needs no window, so it runs under ctest in CI; the game's own
+// --check-allocs covers rendering as well but needs a display.
+
+#include <cstdio>
+#include <memory>
+#include <new>
+
+#include "alloc_tracker.h"
+#include "bot_controller.h"
+#include "game_state.h"
+#include "job_system.h"
+
+static const int kWarmupTicks = 600;
+static const int kCheckedTicks = 20000;
+
+// The tracker has to see every allocation form the arenas can spill through
+static bool trackerCountsAlignedNew() {
+    uint64_t before = allocStats().allocations;
+    char* block = new (std::align_val_t(64)) char[256];
+    bool counted = allocStats().allocations == before + 1 && ((uintptr_t)block & 63) == 0;
+    operator delete[](block, std::align_val_t(64));
+    return counted;
+}
+
+// Returns the number of ticks that allocated
+static int checkSeed(uint64_t seed, JobSystem& jobs) {
+    std::unique_ptr<GameState> game(new GameState(seed));
+    game->jobs = &jobs;
+    BotController bot;
+    int failures = 0;
+    for (int tick = 0; tick < kWarmupTicks + kCheckedTicks; tick++) {
+        if (game->gameOver) game->reset(seed + tick);  // A new game is allowed to set itself up
+        PlayerAction action = bot.nextAction(*game);
+        uint64_t before = allocStats().allocations;
+        game->handleInput(action);
+        game->update(kTickDt);
+        uint64_t allocations = allocStats().allocations - before;
+        if (tick >= kWarmupTicks && allocations > 0) {
+            if (failures < 10) {
+                fprintf(stderr, "seed %llu tick %d (wave %d): update allocated %llu times\n",
+                        (unsigned long long)seed, tick, game->wave, (unsigned long long)allocations);
+            }
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int main() {
+    if (!trackerCountsAlignedNew()) {
+        fprintf(stderr, "FAILED: aligned operator new is not tracked\n");
+        return 1;
+    }
+
+    JobSystem jobs(2);
+    int failures = 0;
+    for (uint64_t seed : {1ull, 7ull, 12345ull}) failures += checkSeed(seed, jobs);
+
+    printf("%s: %d of %d checked ticks allocated\n", failures ? "FAILED" : "passed", failures, 3 * kCheckedTicks);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,174 @@
+#include "alloc_tracker.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Every tracked block carries its size in a header so frees can be
+// accounted for. The header keeps the pointer suitably aligned.
+static const size_t kHeaderSize = alignof(std::max_align_t) > sizeof(size_t) ? alignof(std::max_align_t)
+                                                                             : sizeof(size_t);
+
+static std::atomic<uint64_t> allocationCount{0};
+static std::atomic<uint64_t> allocatedBytes{0};
+static std::atomic<int64_t> liveBytes{0};
+static std::atomic<int64_t> peakBytes{0};
+
+static void noteAllocation(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    int64_t live = liveBytes.fetch_add((int64_t)size, std::memory_order_relaxed) + (int64_t)size;
+    int64_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+AllocStats allocStats() {
+    AllocStats stats;
+    stats.allocations = allocationCount.load(std::memory_order_relaxed);
+    stats.bytes = allocatedBytes.load(std::memory_order_relaxed);
+    stats.live = liveBytes.load(std::memory_order_relaxed);
+    stats.peak = peakBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void resetAllocPeak() {
+    peakBytes.store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void* trackedMalloc(size_t size) {
+    unsigned char* raw = static_cast<unsigned char*>(malloc(kHeaderSize + size));
+    if (!raw) return nullptr;
+    *reinterpret_cast<size_t*>(raw) = size;
+    noteAllocation(size);
+    return raw + kHeaderSize;
+}
+
+void* trackedRealloc(void* block, size_t size) {
+    if (!block) return trackedMalloc(size);
+    unsigned char* raw = static_cast<unsigned char*>(block) - kHeaderSize;
+    size_t oldSize = *reinterpret_cast<size_t*>(raw);
+    raw = static_cast<unsigned char*>(realloc(raw, kHeaderSize + size));
+    if (!raw) return nullptr;
+    *reinterpret_cast<size_t*>(raw) = size;
+    liveBytes.fetch_sub((int64_t)oldSize, std::memory_order_relaxed);
+    noteAllocation(size);
+    return raw + kHeaderSize;
+}
+
+void trackedFree(void* block) {
+    if (!block) return;
+    unsigned char* raw = static_cast<unsigned char*>(block) - kHeaderSize;
+    liveBytes.fetch_sub((int64_t)*reinterpret_cast<size_t*>(raw), std::memory_order_relaxed);
+    free(raw);
+}
+
+// Over-aligned blocks put the requested size and the malloc'd pointer just
+// below the aligned address, so frees can find both.
+static void* trackedAlignedMalloc(size_t size, size_t alignment) {
+    if (alignment < alignof(std::max_align_t)) alignment = alignof(std::max_align_t);
+    const size_t header = 2 * sizeof(size_t);
+    unsigned char* raw = static_cast<unsigned char*>(malloc(header + alignment + size));
+    if (!raw) return nullptr;
+    uintptr_t aligned = ((uintptr_t)raw + header + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    size_t* words = reinterpret_cast<size_t*>(aligned) - 2;
+    words[0] = size;
+    words[1] = (size_t)(uintptr_t)raw;
+    noteAllocation(size);
+    return reinterpret_cast<void*>(aligned);
+}
+
+static void trackedAlignedFree(void* block) {
+    if (!block) return;
+    size_t* words = static_cast<size_t*>(block) - 2;
+    liveBytes.fetch_sub((int64_t)words[0], std::memory_order_relaxed);
+    free(reinterpret_cast<void*>((uintptr_t)words[1]));
+}
+
+// Global replacements, including the aligned (std::align_val_t) forms: the
+// pmr arenas' upstream, new_delete_resource, allocates through those when a
+// wave or tick outgrows its fixed buffer.
+void* operator new(size_t size) {
+    void* block = trackedMalloc(size ? size : 1);
+    if (!block) throw std::bad_alloc();
+    return block;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return trackedMalloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return trackedMalloc(size ? size : 1);
+}
+
+void operator delete(void* block) noexcept {
+    trackedFree(block);
+}
+
+void operator delete[](void* block) noexcept {
+    trackedFree(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    trackedFree(block);
+}
+
+void operator delete[](void* block, size_t) noexcept {
+    trackedFree(block);
+}
+
+void operator delete(void* block, const std::nothrow_t&) noexcept {
+    trackedFree(block);
+}
+
+void operator delete[](void* block, const std::nothrow_t&) noexcept {
+    trackedFree(block);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    void* block = trackedAlignedMalloc(size ? size : 1, (size_t)alignment);
+    if (!block) throw std::bad_alloc();
+    return block;
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return trackedAlignedMalloc(size ? size : 1, (size_t)alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return trackedAlignedMalloc(size ? size : 1, (size_t)alignment);
+}
+
+void operator delete(void* block, std::align_val_t) noexcept {
+    trackedAlignedFree(block);
+}
+
+void operator delete[](void* block, std::align_val_t) noexcept {
+    trackedAlignedFree(block);
+}
+
+void operator delete(void* block, size_t, std::align_val_t) noexcept {
+    trackedAlignedFree(block);
+}
+
+void operator delete[](void* block, size_t, std::align_val_t) noexcept {
+    trackedAlignedFree(block);
+}
+
+void operator delete(void* block, std::align_val_t, const std::nothrow_t&) noexcept {
+    trackedAlignedFree(block);
+}
+
+void operator delete[](void* block, std::align_val_t, const std::nothrow_t&) noexcept {
+    trackedAlignedFree(block);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+// Heap allocation tracking.
+//
+// alloc_tracker.cpp replaces the global operator new/delete, aligned forms
+// included, so every C++ allocation in the process is counted. trackedMalloc/Realloc/Free are the
+// same bookkeeping for C allocators that can be redirected, such as GLFW's
+// (see glfwInitAllocator). Counters are process-wide and updated with relaxed
+// atomics, so allocations on worker threads are included.
+
+#include <cstddef>
+#include <cstdint>
+
+struct AllocStats {
+    uint64_t allocations;  // Total calls so far
+    uint64_t bytes;        // Total bytes requested so far
+    int64_t live;          // Bytes currently allocated
+    int64_t peak;          // High-water mark of live since the last resetAllocPeak
+};
+
+AllocStats allocStats();
+
+// Starts a new peak measurement window at the current live size
+void resetAllocPeak();
+
+void* trackedMalloc(size_t size);
+void* trackedRealloc(void* block, size_t size);
+void trackedFree(void* block);
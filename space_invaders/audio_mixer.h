@@ -0,0 +1,275 @@
+#pragma once
+
+// Sound effects mixed on a dedicated thread.
+//
+// The game thread calls play(), which stamps a small command and pushes it
+// into a lock-free SPSC ring (spsc_ring.h); it never waits for the mixer.
+// The mixer thread drains the ring into a fixed set of voices, mixes them
+// from the preloaded SoundBank into a stereo buffer sized at construction
+// and hands each period to an AudioSink. Nothing on the mixer thread
+// allocates or takes a lock, and the frame loop has no part in producing
+// samples, so a slow frame can't starve audio.
+//
+// Two clocks:
+// - kClockRealTime mixes a period every kPeriodFrames samples of wall time
+//   and starts sounds as soon as their command arrives. If the ring is full
+//   the command is dropped and counted rather than stalling the frame.
+// - kClockGameTime mixes one tick of audio for every advanceTick() and
+//   starts each sound on the tick that played it, so a headless run writes
+//   the same WAV for the same seed at any speed. Here a full ring makes the
+//   game wait for the mixer to catch up, since nothing is presented live.
+//
+// Sinks take interleaved 16-bit stereo. The null and WAV sinks below let
+// audio run without a device; a device backend would be another AudioSink.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "sound_bank.h"
+#include "spsc_ring.h"
+
+class AudioSink {
+public:
+    virtual ~AudioSink() = default;
+    virtual void write(const int16_t* frames, size_t count) = 0;  // count stereo frames
+};
+
+// Discards audio, counting what it was given
+class NullAudioSink : public AudioSink {
+public:
+    void write(const int16_t*, size_t count) override { frames += count; }
+    uint64_t frames = 0;
+};
+
+// Streams audio into a 16-bit stereo WAV file, fixing up its sizes on close
+class WavAudioSink : public AudioSink {
+public:
+    ~WavAudioSink() override { close(); }
+
+    bool open(const char* path) {
+        file = fopen(path, "wb");
+        if (!file) {
+            fprintf(stderr, "Could not open %s for audio\n", path);
+            return false;
+        }
+        writeHeader();
+        return true;
+    }
+
+    void write(const int16_t* frames, size_t count) override {
+        if (file) written += fwrite(frames, 4, count, file);
+    }
+
+    void close() {
+        if (!file) return;
+        fseek(file, 0, SEEK_SET);
+        writeHeader();
+        fclose(file);
+        file = nullptr;
+    }
+
+    uint64_t frames() const { return written; }
+
+private:
+    void writeHeader() {
+        auto u32 = [this](uint32_t v) { fwrite(&v, 4, 1, file); };
+        auto u16 = [this](uint16_t v) { fwrite(&v, 2, 1, file); };
+        uint32_t dataBytes = (uint32_t)(written * 4);
+        fwrite("RIFF", 1, 4, file);
+        u32(36 + dataBytes);
+        fwrite("WAVEfmt ", 1, 8, file);
+        u32(16);
+        u16(1);  // PCM
+        u16(2);  // Channels
+        u32(kAudioSampleRate);
+        u32(kAudioSampleRate * 4);  // Bytes per second
+        u16(4);                     // Bytes per frame
+        u16(16);                    // Bits per sample
+        fwrite("data", 1, 4, file);
+        u32(dataBytes);
+    }
+
+    FILE* file = nullptr;
+    uint64_t written = 0;
+};
+
+class AudioMixer {
+public:
+    enum Clock { kClockRealTime, kClockGameTime };
+
+    static constexpr size_t kPeriodFrames = 256;                     // About 5 ms per real-time period
+    static constexpr size_t kFramesPerTick = kAudioSampleRate / 60;  // One kTickDt of audio
+    static constexpr int kMaxVoices = 24;
+    static constexpr float kMasterVolume = 0.5f;
+
+    AudioMixer(AudioSink& sink, Clock clock)
+        : sink(sink), clock(clock), mixBuffer(std::max(kPeriodFrames, kFramesPerTick) * 2),
+          output(mixBuffer.size()) {
+        worker = std::thread(&AudioMixer::run, this);
+    }
+
+    ~AudioMixer() { stop(); }
+
+    AudioMixer(const AudioMixer&) = delete;
+    AudioMixer& operator=(const AudioMixer&) = delete;
+
+    // Game thread: starts a sound; pan runs from -1 (left) to 1 (right)
+    void play(SoundId id, float volume = 1.0f, float pan = 0.0f) {
+        SoundCommand command = {id, volume, pan, producerTick};
+        while (!commands.push(command)) {
+            // On the game clock, wait while the mixer works through earlier
+            // ticks. A ring full of this tick's sounds only drains after the
+            // tick ends, so that case drops too.
+            if (clock == kClockRealTime || mixedTicks.load(std::memory_order_acquire) == producerTick) {
+                dropped++;
+                return;
+            }
+            std::this_thread::yield();
+        }
+        played++;
+    }
+
+    // Game thread: marks the end of a simulation tick
+    void advanceTick() { publishedTick.store(++producerTick, std::memory_order_release); }
+
+    // Mixes whatever is still owed (all published ticks on the game clock) and joins the thread
+    void stop() {
+        if (!worker.joinable()) return;
+        running.store(false, std::memory_order_release);
+        worker.join();
+    }
+
+    uint64_t playedCommands() const { return played; }
+    uint64_t droppedCommands() const { return dropped; }
+    uint64_t latePeriods() const { return late.load(std::memory_order_relaxed); }  // Real-time periods mixed behind schedule
+
+private:
+    struct SoundCommand {
+        SoundId sound;
+        float volume;
+        float pan;
+        uint64_t tick;  // Game tick it was played on
+    };
+
+    struct Voice {
+        const int16_t* samples;
+        size_t length;
+        size_t position;
+        float left, right;
+    };
+
+    void run() {
+        if (clock == kClockRealTime) runRealTime();
+        else runGameTime();
+    }
+
+    void runRealTime() {
+        const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>((double)kPeriodFrames / kAudioSampleRate));
+        auto deadline = std::chrono::steady_clock::now();
+        while (running.load(std::memory_order_acquire)) {
+            startVoices(UINT64_MAX);
+            mix(kPeriodFrames);
+            deadline += period;
+            auto now = std::chrono::steady_clock::now();
+            if (now > deadline + period) {
+                // Fell more than a period behind: carry on from now rather than burst to catch up
+                late.fetch_add(1, std::memory_order_relaxed);
+                deadline = now;
+            }
+            std::this_thread::sleep_until(deadline);
+        }
+    }
+
+    void runGameTime() {
+        uint64_t tick = 0;
+        for (;;) {
+            // Read the flag first: once it's down, every tick is already published
+            bool stopping = !running.load(std::memory_order_acquire);
+            uint64_t target = publishedTick.load(std::memory_order_acquire);
+            if (tick == target) {
+                if (stopping) break;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                continue;
+            }
+            for (; tick < target; tick++) {
+                startVoices(tick);
+                mix(kFramesPerTick);
+                mixedTicks.store(tick + 1, std::memory_order_release);
+            }
+        }
+    }
+
+    // Starts every queued sound played on or before `tick`
+    void startVoices(uint64_t tick) {
+        while (const SoundCommand* command = commands.front()) {
+            if (command->tick > tick) break;
+            Voice voice = {bank.samples(command->sound), bank.length(command->sound), 0,
+                           command->volume * std::min(1.0f, 1.0f - command->pan),
+                           command->volume * std::min(1.0f, 1.0f + command->pan)};
+            commands.popFront();
+
+            // A full mixer replaces the voice closest to finishing
+            int slot = 0;
+            float mostDone = -1.0f;
+            for (int v = 0; v < kMaxVoices; v++) {
+                if (!voices[v].samples) {
+                    slot = v;
+                    break;
+                }
+                float done = (float)voices[v].position / voices[v].length;
+                if (done > mostDone) {
+                    mostDone = done;
+                    slot = v;
+                }
+            }
+            voices[slot] = voice;
+        }
+    }
+
+    // Mixes `frames` stereo frames of every live voice and hands them to the sink
+    void mix(size_t frames) {
+        std::fill(mixBuffer.begin(), mixBuffer.begin() + frames * 2, 0.0f);
+        for (Voice& voice : voices) {
+            if (!voice.samples) continue;
+            size_t count = std::min(frames, voice.length - voice.position);
+            const int16_t* in = voice.samples + voice.position;
+            for (size_t i = 0; i < count; i++) {
+                mixBuffer[i * 2] += in[i] * voice.left;
+                mixBuffer[i * 2 + 1] += in[i] * voice.right;
+            }
+            voice.position += count;
+            if (voice.position == voice.length) voice.samples = nullptr;
+        }
+        for (size_t i = 0; i < frames * 2; i++) {
+            float s = mixBuffer[i] * kMasterVolume;
+            output[i] = (int16_t)(s < -32768.0f ? -32768.0f : s > 32767.0f ? 32767.0f : s);
+        }
+        sink.write(output.data(), frames);
+    }
+
+    AudioSink& sink;
+    const Clock clock;
+    SoundBank bank;
+    SpscRing<SoundCommand, 256> commands;
+    Voice voices[kMaxVoices] = {};
+    std::vector<float> mixBuffer;  // Interleaved stereo, sized for the longest period
+    std::vector<int16_t> output;
+
+    // Game thread only
+    uint64_t producerTick = 0;
+    uint64_t played = 0;
+    uint64_t dropped = 0;
+
+    std::atomic<uint64_t> publishedTick{0};
+    std::atomic<uint64_t> mixedTicks{0};  // Game clock: ticks whose audio is done
+    std::atomic<uint64_t> late{0};
+    std::atomic<bool> running{true};
+    std::thread worker;
+};
@@ -0,0 +1,39 @@
+// C interface of the batch environment (see batch_env_c.h)
+
+#include "batch_env_c.h"
+#include "batch_env.h"
+
+struct SiBatch {
+    BatchEnv env;
+};
+
+int si_observation_size(void) { return BatchEnv::kObservationSize; }
+int si_action_count(void) { return BatchEnv::kActionCount; }
+
+SiBatch* si_batch_create(int count, uint64_t seed, int threads) {
+    if (count < 1) return nullptr;
+    return new SiBatch{BatchEnv(count, seed, threads)};
+}
+
+void si_batch_destroy(SiBatch* batch) { delete batch; }
+int si_batch_size(const SiBatch* batch) { return batch->env.size(); }
+
+void si_batch_reset(SiBatch* batch) { batch->env.reset(); }
+void si_batch_step(SiBatch* batch, const int32_t* actions) { batch->env.step(actions); }
+
+const float* si_batch_observations(const SiBatch* batch) { return batch->env.observations(); }
+const float* si_batch_rewards(const SiBatch* batch) { return batch->env.rewards(); }
+const uint8_t* si_batch_dones(const SiBatch* batch) { return batch->env.dones(); }
+
+int si_batch_enable_pixels(SiBatch* batch, int width, int height, int channels) {
+    if (width < 1 || height < 1) return 0;
+    RasterFormat format;
+    format.width = width;
+    format.height = height;
+    format.channels = channels != 0;
+    batch->env.enablePixels(format);
+    return (int)format.bytes();
+}
+
+int si_batch_pixel_bytes(const SiBatch* batch) { return (int)batch->env.pixelBytes(); }
+const uint8_t* si_batch_pixels(const SiBatch* batch) { return batch->env.pixels(); }
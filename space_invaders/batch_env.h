@@ -0,0 +1,185 @@
+#pragma once
+
+// Steps many games at once, for training agents.
+//
+// A BatchEnv owns N independent games and advances all of them one tick per
+// step, spread over a job system in chunks of games. Actions go in as one
+// int per game; observations, rewards and done flags come out as flat
+// arrays indexed by game (observations are N rows of kObservationSize
+// floats), allocated once and rewritten in place every step. A finished game
+// reports done and is immediately reset, so its row already holds the first
+// observation of the next episode.
+//
+// Games have effects turned off and draw nothing unless pixel observations
+// are enabled, in which case each game is also rasterized into a small
+// uint8 image (observation_raster.h) next to its feature row. Each episode is seeded
+// from the batch seed, the game's index and its episode count, so a batch
+// replays identically for the same seed and actions regardless of threads.
+// batch_env_c.h wraps this in a C ABI for foreign function interfaces.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "game_state.h"
+#include "job_system.h"
+#include "observation_raster.h"
+
+class BatchEnv {
+public:
+    // Action a moves by a % 3 - 1 (left, stay, right) and fires if a / 3 is 1
+    static constexpr int kActionCount = 6;
+
+    // Observation layout, all values roughly in [-1, 1]
+    static constexpr int kPlayerFeatures = 8;     // x, cooldown, lives, wave, four power-up timers
+    static constexpr int kFormationRows = 8;      // Rows past these are left out
+    static constexpr int kFormationCols = 6;
+    static constexpr int kFormationFeatures = 2 + kFormationRows * kFormationCols;  // Origin, then cell types
+    static constexpr int kObservedBullets = 8;    // Nearest enemy bullets to the player
+    static constexpr int kBulletFeatures = 3;     // Present, dx, dy
+    static constexpr int kObservationSize =
+        kPlayerFeatures + kFormationFeatures + kObservedBullets * kBulletFeatures;
+
+    // Games per job; small enough to balance, large enough to amortize scheduling
+    static constexpr size_t kGamesPerJob = 16;
+
+    // `threads` extra workers join the calling thread; 0 steps on the caller only
+    BatchEnv(int count, uint64_t seed, int threads)
+        : baseSeed(seed), episodes(count, 0), observationBuffer((size_t)count * kObservationSize),
+          rewardBuffer(count), doneBuffer(count), jobs(threads > 0 ? threads : 0) {
+        games.reserve(count);
+        for (int i = 0; i < count; i++) games.emplace_back(new GameState(episodeSeed(i), 0));
+        reset();
+    }
+
+    int size() const { return (int)games.size(); }
+
+    const float* observations() const { return observationBuffer.data(); }
+    const float* rewards() const { return rewardBuffer.data(); }
+    const uint8_t* dones() const { return doneBuffer.data(); }
+    const uint8_t* pixels() const { return pixelBuffer.data(); }  // Null until enablePixels
+    size_t pixelBytes() const { return pixelBuffer.empty() ? 0 : raster.rasterFormat().bytes(); }  // Per game
+
+    // Also draws every game into format.bytes() of pixels() from now on
+    void enablePixels(const RasterFormat& format) {
+        raster = ObservationRaster(format);
+        pixelBuffer.assign(games.size() * format.bytes(), 0);
+        jobs.parallelFor(games.size(), kGamesPerJob, [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) observe(i);
+        });
+    }
+    const GameState& game(int i) const { return *games[i]; }
+
+    // Restarts every game from its first episode
+    void reset() {
+        jobs.parallelFor(games.size(), kGamesPerJob, [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                episodes[i] = 0;
+                games[i]->reset(episodeSeed(i));
+                rewardBuffer[i] = 0;
+                doneBuffer[i] = 0;
+                observe(i);
+            }
+        });
+    }
+
+    // Applies actions[i] to game i for one tick; actions outside
+    // [0, kActionCount) stand still without firing
+    void step(const int32_t* actions) {
+        jobs.parallelFor(games.size(), kGamesPerJob, [this, actions](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                GameState& game = *games[i];
+                int a = actions[i] >= 0 && actions[i] < kActionCount ? actions[i] : 1;
+                PlayerAction action;
+                action.move = a % 3 - 1;
+                action.fire = a / 3 != 0;
+
+                int before = game.score;
+                game.handleInput(action);
+                game.update(kTickDt);
+                rewardBuffer[i] = (float)(game.score - before);
+                doneBuffer[i] = game.gameOver;
+                if (game.gameOver) {
+                    episodes[i]++;
+                    game.reset(episodeSeed(i));
+                }
+                observe(i);
+            }
+        });
+    }
+
+private:
+    uint64_t episodeSeed(size_t i) const {
+        return baseSeed ^ ((uint64_t)i << 32 | episodes[i]) * 0xbf58476d1ce4e5b9ull;
+    }
+
+    void observe(size_t i) {
+        const GameState& game = *games[i];
+        float* o = &observationBuffer[i * kObservationSize];
+
+        *o++ = game.playerX / 640.0f;
+        *o++ = std::max(game.shotCooldown, 0.0f) / 0.2f;
+        *o++ = game.lives / 3.0f;
+        *o++ = game.wave / 10.0f;
+        *o++ = std::max(game.shieldActive, 0.0f);
+        *o++ = std::max(game.rapidFireActive, 0.0f) / 8.0f;
+        *o++ = std::max(game.multiShotActive, 0.0f) / 10.0f;
+        *o++ = std::max(game.slowMotionActive, 0.0f) / 5.0f;
+
+        // Cells hold 0 when empty, else (type + 1) / kEnemyTypeCount
+        const Formation& enemies = game.enemies;
+        *o++ = enemies.originX / 640.0f;
+        *o++ = enemies.originY / 480.0f;
+        for (int row = 0; row < kFormationRows; row++) {
+            for (int col = 0; col < kFormationCols; col++) {
+                float cell = 0;
+                if (row < (int)enemies.rows.size() && col < enemies.cols) {
+                    const FormationRow& r = enemies.rows[row];
+                    uint64_t bit = 1ull << col;
+                    for (int t = 0; t < kEnemyTypeCount && (r.alive & bit); t++) {
+                        if (r.type[t] & bit) cell = (float)(t + 1) / kEnemyTypeCount;
+                    }
+                }
+                *o++ = cell;
+            }
+        }
+
+        // Nearest live enemy bullets, closest first; missing ones are all zero
+        int nearest[kObservedBullets];
+        float distance[kObservedBullets];
+        int found = 0;
+        const Position* pos = game.enemyBullets.get<Position>();
+        for (size_t b = 0; b < game.enemyBullets.size(); b++) {
+            if (!game.enemyBullets.isAlive(b)) continue;
+            float dx = pos[b].x - game.playerX, dy = pos[b].y - game.playerY;
+            float d = dx * dx + dy * dy;
+            if (found == kObservedBullets && d >= distance[found - 1]) continue;
+            int k = found < kObservedBullets ? found++ : found - 1;
+            for (; k > 0 && distance[k - 1] > d; k--) {
+                nearest[k] = nearest[k - 1];
+                distance[k] = distance[k - 1];
+            }
+            nearest[k] = (int)b;
+            distance[k] = d;
+        }
+        for (int k = 0; k < kObservedBullets; k++) {
+            *o++ = k < found ? 1.0f : 0.0f;
+            *o++ = k < found ? (pos[nearest[k]].x - game.playerX) / 640.0f : 0.0f;
+            *o++ = k < found ? (pos[nearest[k]].y - game.playerY) / 480.0f : 0.0f;
+        }
+
+        if (!pixelBuffer.empty()) raster.draw(game, &pixelBuffer[i * raster.rasterFormat().bytes()]);
+    }
+
+    uint64_t baseSeed;
+    std::vector<std::unique_ptr<GameState>> games;  // GameState owns arenas and can't move
+    std::vector<uint32_t> episodes;
+    std::vector<float> observationBuffer;
+    std::vector<float> rewardBuffer;
+    std::vector<uint8_t> doneBuffer;
+    ObservationRaster raster;
+    std::vector<uint8_t> pixelBuffer;
+    JobSystem jobs;
+};
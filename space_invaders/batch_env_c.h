@@ -0,0 +1,57 @@
+#pragma once
+
+/* C interface to BatchEnv (batch_env.h), built as the space_invaders_env
+ * shared library for use from Python (ctypes, cffi) and other languages.
+ *
+ * Output arrays are owned by the batch and rewritten in place by every
+ * reset and step; they stay valid until si_batch_destroy:
+ *   observations  count * si_observation_size() floats, one row per game
+ *   rewards       count floats, the score gained by the last step
+ *   dones         count bytes, 1 where the last step ended a game, which
+ *                 was then reset and its row holds the new game
+ *   pixels        count * si_batch_pixel_bytes() bytes once pixels are
+ *                 enabled, one image per game (see observation_raster.h) */
+
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(SI_ENV_BUILD)
+#define SI_ENV_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define SI_ENV_API __declspec(dllimport)
+#else
+#define SI_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct SiBatch SiBatch;
+
+SI_ENV_API int si_observation_size(void);
+SI_ENV_API int si_action_count(void);
+
+/* `threads` workers help the calling thread; null if count < 1 */
+SI_ENV_API SiBatch* si_batch_create(int count, uint64_t seed, int threads);
+SI_ENV_API void si_batch_destroy(SiBatch* batch);
+SI_ENV_API int si_batch_size(const SiBatch* batch);
+
+SI_ENV_API void si_batch_reset(SiBatch* batch);
+/* actions: count ints in [0, si_action_count()) */
+SI_ENV_API void si_batch_step(SiBatch* batch, const int32_t* actions);
+
+SI_ENV_API const float* si_batch_observations(const SiBatch* batch);
+SI_ENV_API const float* si_batch_rewards(const SiBatch* batch);
+SI_ENV_API const uint8_t* si_batch_dones(const SiBatch* batch);
+
+/* Also rasterizes every game into a width x height image, one gray plane or,
+ * with channels set, one 0/255 mask plane per object kind (player, enemies,
+ * player bullets, enemy bullets, power-ups, bunkers). Returns the bytes per
+ * game. */
+SI_ENV_API int si_batch_enable_pixels(SiBatch* batch, int width, int height, int channels);
+SI_ENV_API int si_batch_pixel_bytes(const SiBatch* batch);
+SI_ENV_API const uint8_t* si_batch_pixels(const SiBatch* batch);
+
+#ifdef __cplusplus
+}
+#endif
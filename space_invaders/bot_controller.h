@@ -0,0 +1,56 @@
+#pragma once
+
+// A built-in player for demos, headless runs and benchmarks.
+
+#include <cmath>
+
+#include "controller.h"
+#include "game_state.h"
+
+// Plays from the game state: steps away from enemy bullets about to reach
+// the ship, otherwise lines up under the nearest live column and fires.
+class BotController : public Controller {
+public:
+    PlayerAction nextAction(const GameState& game) override {
+        PlayerAction a;
+        if (game.paused || game.gameOver) return a;
+        
+        // Closest bullet that reaches the ship's height soon and would land on it
+        const Position* pos = game.enemyBullets.get<Position>();
+        const Velocity* vel = game.enemyBullets.get<Velocity>();
+        bool threatened = false;
+        float threatDx = 0;
+        for (size_t i = 0; i < game.enemyBullets.size(); i++) {
+            if (!game.enemyBullets.isAlive(i) || vel[i].dy <= 0) continue;
+            float eta = (game.playerY - 20 - pos[i].y) / vel[i].dy;
+            float dx = pos[i].x - game.playerX;
+            if (eta < -0.1f || eta > kLookahead || std::fabs(dx) > 28) continue;
+            if (!threatened || std::fabs(dx) < std::fabs(threatDx)) threatDx = dx;
+            threatened = true;
+        }
+        
+        // Nearest live column
+        uint64_t columns = game.enemies.liveColumns();
+        float targetDx = 0;
+        bool haveTarget = false;
+        while (columns) {
+            float dx = game.enemies.cellX(lowestBit(columns)) - game.playerX;
+            columns &= columns - 1;
+            if (!haveTarget || std::fabs(dx) < std::fabs(targetDx)) targetDx = dx;
+            haveTarget = true;
+        }
+        
+        if (threatened) {
+            a.move = threatDx > 0 ? -1 : 1;
+            if (a.move < 0 && game.playerX <= 27) a.move = 1;  // Cornered: dodge the other way
+            if (a.move > 0 && game.playerX >= 613) a.move = -1;
+        } else if (haveTarget && std::fabs(targetDx) > 4) {
+            a.move = targetDx > 0 ? 1 : -1;
+        }
+        a.fire = haveTarget && std::fabs(targetDx) < 15;
+        return a;
+    }
+    
+private:
+    static constexpr float kLookahead = 0.5f;  // Seconds
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+// Draws the bunker band from a texture that mirrors its bitmask.
+//
+// The texture holds one byte per cell (kBunkerCols x kBunkerRows, 0 or
+// 255) and is drawn as a single tinted quad over the band. The renderer
+// keeps a copy of the mask it last uploaded; each frame it compares rows
+// word by word and re-uploads only runs of rows that changed, so an intact
+// band costs a few compares and a crater a handful of rows. Requires a GL
+// 3.3 context with its functions loaded.
+
+#include <glad/gl.h>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "bunkers.h"
+#include "gl_shader.h"
+
+class BunkerRenderer {
+public:
+    BunkerRenderer(float viewWidth, float viewHeight) : cells((size_t)kBunkerCols * kBunkerRows, 0) {
+        memset(uploaded, 0, sizeof(uploaded));
+
+        program = buildProgram("Bunker", kVertexShader, kFragmentShader);
+        if (!program) return;
+        glUseProgram(program);
+        glUniform2f(glGetUniformLocation(program, "viewSize"), viewWidth, viewHeight);
+        glUniform4f(glGetUniformLocation(program, "band"), 0.0f, kBunkerTop, kBunkerCols * (float)kBunkerCellSize,
+                    kBunkerBottom);
+        glUniform1i(glGetUniformLocation(program, "mask"), 0);
+        colorLocation = glGetUniformLocation(program, "color");
+        glUseProgram(0);
+
+        // Starts empty, matching `uploaded`
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, kBunkerCols, kBunkerRows, 0, GL_RED, GL_UNSIGNED_BYTE, cells.data());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        // The quad's corners come from gl_VertexID; the VAO only satisfies the core profile
+        glGenVertexArrays(1, &vao);
+    }
+
+    ~BunkerRenderer() {
+        glDeleteVertexArrays(1, &vao);
+        glDeleteTextures(1, &texture);
+        glDeleteProgram(program);
+    }
+
+    BunkerRenderer(const BunkerRenderer&) = delete;
+    BunkerRenderer& operator=(const BunkerRenderer&) = delete;
+
+    void draw(const Bunkers& bunkers, float r, float g, float b) {
+        if (!program) return;
+        glBindTexture(GL_TEXTURE_2D, texture);
+        upload(bunkers);
+
+        glUseProgram(program);
+        glUniform4f(colorLocation, r, g, b, 1.0f);
+        glActiveTexture(GL_TEXTURE0);
+        glBindVertexArray(vao);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        glBindVertexArray(0);
+        glUseProgram(0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+private:
+    // Re-uploads each run of consecutive rows that differ from the last upload
+    void upload(const Bunkers& bunkers) {
+        int row = 0;
+        while (row < kBunkerRows) {
+            if (!changed(bunkers, row)) {
+                row++;
+                continue;
+            }
+            int first = row;
+            for (; row < kBunkerRows && changed(bunkers, row); row++) {
+                const uint64_t* words = bunkers.row(row);
+                uint8_t* out = &cells[(size_t)row * kBunkerCols];
+                for (int col = 0; col < kBunkerCols; col++) out[col] = (words[col / 64] >> (col % 64)) & 1 ? 255 : 0;
+                memcpy(uploaded[row], words, sizeof(uploaded[row]));
+            }
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, first, kBunkerCols, row - first, GL_RED, GL_UNSIGNED_BYTE,
+                            &cells[(size_t)first * kBunkerCols]);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        }
+    }
+
+    bool changed(const Bunkers& bunkers, int row) const {
+        return memcmp(uploaded[row], bunkers.row(row), sizeof(uploaded[row])) != 0;
+    }
+
+    static constexpr const char* kVertexShader = R"(#version 330 core
+uniform vec2 viewSize;
+uniform vec4 band;  // minX, minY, maxX, maxY in game coordinates
+out vec2 texCoord;
+void main() {
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vec2 position = mix(band.xy, band.zw, corner);
+    gl_Position = vec4(position.x / viewSize.x * 2.0 - 1.0, 1.0 - position.y / viewSize.y * 2.0, 0.0, 1.0);
+    texCoord = corner;
+}
+)";
+
+    static constexpr const char* kFragmentShader = R"(#version 330 core
+in vec2 texCoord;
+uniform sampler2D mask;
+uniform vec4 color;
+out vec4 fragColor;
+void main() {
+    fragColor = vec4(color.rgb, color.a * texture(mask, texCoord).r);
+}
+)";
+
+    uint64_t uploaded[kBunkerRows][kBunkerWords];  // Mask as of the last upload
+    std::vector<uint8_t> cells;                    // Staging, one byte per cell
+    GLuint program = 0;
+    GLuint texture = 0;
+    GLuint vao = 0;
+    GLint colorLocation = -1;
+};
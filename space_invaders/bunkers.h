@@ -0,0 +1,253 @@
+#pragma once
+
+// Destructible bunkers stored as one bitmask.
+//
+// The bunkers sit in a horizontal band between the formation and the ship.
+// The band is a grid of 2x2 px cells, kBunkerCols wide and kBunkerRows
+// tall, and each row is a few 64-bit words with one bit per solid cell.
+// Anything up to 64 cells wide covers two adjacent words of a row, so every
+// operation is one 128-bit op per row (SSE2 where available):
+// - a bullet hit test ANDs its cells' mask with each row it crossed this tick
+// - a crater clears a precomputed shape with an and-not per row
+// - an enemy touching the band clears its box the same way
+// Cost depends on the bullets near the band and the rows they cross, never
+// on the number of cells. Rows carry a spare word so a span starting in the
+// last word still has a neighbor.
+
+#include <cstdint>
+#include <cstring>
+
+#include "formation.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BUNKERS_SSE2 1
+#endif
+
+constexpr int kBunkerCellSize = 2;                   // World pixels per cell side
+constexpr int kBunkerCols = 640 / kBunkerCellSize;   // Cells across the band
+constexpr int kBunkerRows = 32;                      // Cells down the band
+constexpr int kBunkerWords = kBunkerCols / 64 + 1;   // Words per row, spare included
+constexpr float kBunkerTop = 320.0f;                 // World y of the band
+constexpr float kBunkerBottom = kBunkerTop + kBunkerRows * kBunkerCellSize;
+constexpr int kBunkerCount = 4;
+
+namespace bunker_art {
+// One bunker at half resolution; each '#' becomes 2x2 cells
+constexpr const char* shape[] = {
+    "....##############....",
+    "...################...",
+    "..##################..",
+    ".####################.",
+    "######################",
+    "######################",
+    "######################",
+    "######################",
+    "######################",
+    "######################",
+    "######################",
+    "######################",
+    "#######........#######",
+    "######..........######",
+    "#####............#####",
+    "#####............#####",
+};
+constexpr int shapeWidth = 22;
+constexpr int shapeRows = 16;
+
+// Craters, in cells, centered on the hit; bullets chip ragged holes
+constexpr const char* playerCrater[] = {
+    "..#..#..",
+    "#.####.#",
+    ".######.",
+    "########",
+    "########",
+    ".######.",
+    "#.####..",
+    "..#..#.#",
+};
+constexpr const char* enemyCrater[] = {
+    "#..#..#.",
+    ".#####.#",
+    "#######.",
+    ".#######",
+    "########",
+    "#######.",
+    ".##.###.",
+    "#...#..#",
+};
+constexpr int craterSize = 8;
+}  // namespace bunker_art
+
+class Bunkers {
+public:
+    Bunkers() {
+        for (int r = 0; r < bunker_art::craterSize; r++) {
+            playerCrater[r] = parseRow(bunker_art::playerCrater[r]);
+            enemyCrater[r] = parseRow(bunker_art::enemyCrater[r]);
+        }
+        reset();
+    }
+
+    // Rebuilds every bunker intact, evenly spaced across the band
+    void reset() {
+        memset(rows, 0, sizeof(rows));
+        const int width = bunker_art::shapeWidth * 2;
+        for (int b = 0; b < kBunkerCount; b++) {
+            int left = kBunkerCols * (b + 1) / (kBunkerCount + 1) - width / 2;
+            for (int r = 0; r < bunker_art::shapeRows * 2; r++) {
+                const char* line = bunker_art::shape[r / 2];
+                for (int c = 0; c < width; c++) {
+                    if (line[c / 2] == '#') rows[r][(left + c) / 64] |= 1ull << ((left + c) % 64);
+                }
+            }
+        }
+    }
+
+    // Sweeps a bullet's leading edge from y0 to y1 at x, `halfWidth` px to
+    // either side, and returns the first solid row it reaches, or -1
+    int sweep(float x, float halfWidth, float y0, float y1) const {
+        if ((y0 < kBunkerTop && y1 < kBunkerTop) || (y0 >= kBunkerBottom && y1 >= kBunkerBottom)) return -1;
+        int first = clampRow(cellRow(y0)), last = clampRow(cellRow(y1));
+        int step = last >= first ? 1 : -1;
+
+        Span span = columnSpan(x - halfWidth, x + halfWidth);
+        if (span.empty) return -1;
+        for (int r = first;; r += step) {
+            if (anySet(&rows[r][span.word], span)) return r;
+            if (r == last) return -1;
+        }
+    }
+
+    // Clears a crater centered on x and the given row
+    void erode(float x, int row, bool fromPlayer) {
+        const uint64_t* crater = fromPlayer ? playerCrater : enemyCrater;
+        int col = cellCol(x) - bunker_art::craterSize / 2;
+        int skip = col < 0 ? -col : 0;  // Crater columns off the left edge
+        col += skip;
+        if (skip >= bunker_art::craterSize || col >= kBunkerCols) return;
+        int word = col / 64, shift = col % 64;
+        for (int r = 0; r < bunker_art::craterSize; r++) {
+            int y = row - bunker_art::craterSize / 2 + r;
+            if (y < 0 || y >= kBunkerRows) continue;
+            uint64_t bits = crater[r] >> skip;
+            clear(&rows[y][word], Span{word, bits << shift, shift ? bits >> (64 - shift) : 0, false});
+        }
+    }
+
+    // Clears every cell under a world-space box
+    void clearBox(float minX, float minY, float maxX, float maxY) {
+        if (maxY < kBunkerTop || minY >= kBunkerBottom) return;
+        Span span = columnSpan(minX, maxX);
+        if (span.empty) return;
+        int r0 = clampRow(cellRow(minY)), r1 = clampRow(cellRow(maxY));
+        for (int r = r0; r <= r1; r++) clear(&rows[r][span.word], span);
+    }
+
+    // ORs rows [r0, r1] into kBunkerWords words: the columns solid in any of them
+    void mergeRows(int r0, int r1, uint64_t* merged) const {
+        memset(merged, 0, kBunkerWords * sizeof(uint64_t));
+        for (int r = r0; r <= r1; r++) {
+            for (int w = 0; w < kBunkerWords; w++) merged[w] |= rows[r][w];
+        }
+    }
+
+    // Calls fn(first, last) for each run of solid columns in a row (or
+    // merged rows), left to right
+    template <typename F>
+    static void forEachRun(const uint64_t* words, F&& fn) {
+        int col = 0;
+        while ((col = nextColumn(words, col, true)) < kBunkerCols) {
+            int end = nextColumn(words, col, false);
+            fn(col, end - 1);
+            col = end;
+        }
+    }
+
+    bool solid(int row, int col) const { return (rows[row][col / 64] >> (col % 64)) & 1; }
+    const uint64_t* row(int r) const { return rows[r]; }  // kBunkerWords words, column c at bit c % 64 of word c / 64
+
+    static float cellY(int row) { return kBunkerTop + row * (float)kBunkerCellSize; }
+
+private:
+    // Up to 64 cells of a row as a mask over words [word, word + 1]
+    struct Span {
+        int word;
+        uint64_t low, high;
+        bool empty;
+    };
+
+    static int cellRow(float y) {
+        float r = (y - kBunkerTop) / kBunkerCellSize;
+        return r < 0 ? -1 : (int)r;
+    }
+    static int cellCol(float x) {
+        float c = x / kBunkerCellSize;
+        return c < 0 ? -1 : (int)c;
+    }
+    static int clampRow(int r) { return r < 0 ? 0 : r >= kBunkerRows ? kBunkerRows - 1 : r; }
+
+    // Spans are at most 64 cells, so they touch at most two words
+    static Span columnSpan(float minX, float maxX) {
+        int c0 = cellCol(minX), c1 = cellCol(maxX);
+        if (c0 < 0) c0 = 0;
+        if (c1 >= kBunkerCols) c1 = kBunkerCols - 1;
+        if (c1 - c0 >= 64) c1 = c0 + 63;
+        Span span{c0 / 64, 0, 0, c1 < c0};
+        if (span.empty) return span;
+        uint64_t bits = (c1 - c0 == 63) ? ~0ull : (1ull << (c1 - c0 + 1)) - 1;
+        int shift = c0 % 64;
+        span.low = bits << shift;
+        span.high = shift ? bits >> (64 - shift) : 0;
+        return span;
+    }
+
+    // `words` points at rows[r][span.word]
+    static bool anySet(const uint64_t* words, const Span& span) {
+#ifdef BUNKERS_SSE2
+        __m128i hit = _mm_and_si128(_mm_loadu_si128((const __m128i*)words), spanMask(span));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(hit, _mm_setzero_si128())) != 0xFFFF;
+#else
+        return ((words[0] & span.low) | (words[1] & span.high)) != 0;
+#endif
+    }
+
+    static void clear(uint64_t* words, const Span& span) {
+#ifdef BUNKERS_SSE2
+        __m128i row = _mm_loadu_si128((const __m128i*)words);
+        _mm_storeu_si128((__m128i*)words, _mm_andnot_si128(spanMask(span), row));
+#else
+        words[0] &= ~span.low;
+        words[1] &= ~span.high;
+#endif
+    }
+
+#ifdef BUNKERS_SSE2
+    static __m128i spanMask(const Span& span) {
+        return _mm_set_epi64x((long long)span.high, (long long)span.low);
+    }
+#endif
+
+    // First column at or after `col` that is solid (or clear), else past the end.
+    // The spare word is always clear, so a run never extends past the band.
+    static int nextColumn(const uint64_t* words, int col, bool solid) {
+        for (int w = col / 64; w < kBunkerWords; w++) {
+            uint64_t bits = solid ? words[w] : ~words[w];
+            if (w == col / 64) bits &= ~0ull << (col % 64);
+            if (bits) return w * 64 + lowestBit(bits);
+        }
+        return kBunkerWords * 64;
+    }
+
+    static uint64_t parseRow(const char* line) {
+        uint64_t bits = 0;
+        for (int c = 0; line[c]; c++) {
+            if (line[c] == '#') bits |= 1ull << c;
+        }
+        return bits;
+    }
+
+    uint64_t rows[kBunkerRows][kBunkerWords];
+    uint64_t playerCrater[bunker_art::craterSize];
+    uint64_t enemyCrater[bunker_art::craterSize];
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+// Swept collision tests.
+//
+// Moving objects are tested along the segment they covered during the tick
+// rather than at their end point, so a large timestep cannot carry a bullet
+// through a target.
+
+// Slab test of the segment (x0, y0) -> (x1, y1) against the open box
+// (minX, maxX) x (minY, maxY). On a hit, t is the fraction of the segment
+// at which it enters the box (0 if it starts inside).
+inline bool segmentHitsBox(float x0, float y0, float x1, float y1,
+                           float minX, float minY, float maxX, float maxY, float& t) {
+    float enter = 0.0f, leave = 1.0f;
+    const float start[2] = {x0, y0};
+    const float delta[2] = {x1 - x0, y1 - y0};
+    const float lo[2] = {minX, minY};
+    const float hi[2] = {maxX, maxY};
+
+    for (int axis = 0; axis < 2; axis++) {
+        if (delta[axis] == 0.0f) {
+            if (start[axis] <= lo[axis] || start[axis] >= hi[axis]) return false;
+            continue;
+        }
+        float a = (lo[axis] - start[axis]) / delta[axis];
+        float b = (hi[axis] - start[axis]) / delta[axis];
+        if (a > b) {
+            float swap = a;
+            a = b;
+            b = swap;
+        }
+        if (a > enter) enter = a;
+        if (b < leave) leave = b;
+        if (enter >= leave) return false;
+    }
+
+    t = enter;
+    return true;
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+// Player controllers.
+//
+// The simulation takes one PlayerAction per tick and never looks at a
+// keyboard or window. A Controller decides that action, given the game it
+// is playing: from keys (keyboard_controller.h), a recorded replay, a
+// script, or a bot that reads the game state. Because actions are all the
+// player contributes, a replay of them plus the random seed reproduces a
+// game exactly.
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+struct GameState;
+
+struct PlayerAction {
+    int move = 0;              // -1 left, 0 stay, 1 right
+    bool fire = false;
+    bool togglePause = false;
+};
+
+class Controller {
+public:
+    virtual ~Controller() {}
+    virtual PlayerAction nextAction(const GameState& game) = 0;
+};
+
+// Replay files: an 8-byte magic, the 32-bit game seed, then one byte per tick
+static const char kReplayMagic[8] = {'S', 'I', 'R', 'P', 'L', 'A', 'Y', '1'};
+
+enum ReplayBits : uint8_t {
+    kReplayLeft = 1 << 0,
+    kReplayRight = 1 << 1,
+    kReplayFire = 1 << 2,
+    kReplayPause = 1 << 3,
+};
+
+inline uint8_t encodeAction(const PlayerAction& a) {
+    return (uint8_t)((a.move < 0 ? kReplayLeft : 0) | (a.move > 0 ? kReplayRight : 0) | (a.fire ? kReplayFire : 0) |
+                     (a.togglePause ? kReplayPause : 0));
+}
+
+inline PlayerAction decodeAction(uint8_t bits) {
+    PlayerAction a;
+    a.move = (bits & kReplayLeft) ? -1 : (bits & kReplayRight) ? 1 : 0;
+    a.fire = (bits & kReplayFire) != 0;
+    a.togglePause = (bits & kReplayPause) != 0;
+    return a;
+}
+
+// Passes another controller's actions through and writes them to a replay file
+class RecordingController : public Controller {
+public:
+    RecordingController(Controller& source, const char* path, uint32_t seed) : source(source) {
+        file = fopen(path, "wb");
+        if (!file) {
+            fprintf(stderr, "Could not create replay %s\n", path);
+            return;
+        }
+        fwrite(kReplayMagic, 1, sizeof(kReplayMagic), file);
+        fwrite(&seed, sizeof(seed), 1, file);
+    }
+
+    ~RecordingController() override {
+        if (file) fclose(file);
+    }
+
+    PlayerAction nextAction(const GameState& game) override {
+        PlayerAction a = source.nextAction(game);
+        if (file) fputc(encodeAction(a), file);
+        return a;
+    }
+
+private:
+    Controller& source;
+    FILE* file = nullptr;
+};
+
+// Plays a replay file back; stands still once it runs out
+class ReplayController : public Controller {
+public:
+    bool open(const char* path) {
+        FILE* file = fopen(path, "rb");
+        char magic[sizeof(kReplayMagic)];
+        if (!file || fread(magic, 1, sizeof(magic), file) != sizeof(magic) ||
+            memcmp(magic, kReplayMagic, sizeof(magic)) != 0 || fread(&recordedSeed, sizeof(recordedSeed), 1, file) != 1) {
+            fprintf(stderr, "Could not read replay %s\n", path);
+            if (file) fclose(file);
+            return false;
+        }
+        int c;
+        while ((c = fgetc(file)) != EOF) actions.push_back((uint8_t)c);
+        fclose(file);
+        return true;
+    }
+
+    uint32_t seed() const { return recordedSeed; }
+    size_t length() const { return actions.size(); }
+    bool finished() const { return next >= actions.size(); }
+
+    PlayerAction nextAction(const GameState&) override {
+        return next < actions.size() ? decodeAction(actions[next++]) : PlayerAction();
+    }
+
+private:
+    std::vector<uint8_t> actions;
+    size_t next = 0;
+    uint32_t recordedSeed = 0;
+};
+
+// Runs a text script of "<ticks> [left|right] [fire] [pause]" lines, each
+// holding that action for the given number of ticks, and loops at the end.
+// '#' starts a comment.
+class ScriptedController : public Controller {
+public:
+    bool open(const char* path) {
+        FILE* file = fopen(path, "r");
+        if (!file) {
+            fprintf(stderr, "Could not read script %s\n", path);
+            return false;
+        }
+        char line[256];
+        int lineNumber = 0;
+        bool ok = true;
+        while (ok && fgets(line, sizeof(line), file)) {
+            lineNumber++;
+            if (char* comment = strchr(line, '#')) *comment = '\0';
+            Step step;
+            int consumed = 0;
+            if (sscanf(line, " %d%n", &step.ticks, &consumed) != 1) {
+                ok = line[strspn(line, " \t\r\n")] == '\0';  // Blank lines are fine
+                continue;
+            }
+            for (char* word = strtok(line + consumed, " \t\r\n"); word && ok; word = strtok(nullptr, " \t\r\n")) {
+                if (strcmp(word, "left") == 0) step.action.move = -1;
+                else if (strcmp(word, "right") == 0) step.action.move = 1;
+                else if (strcmp(word, "fire") == 0) step.action.fire = true;
+                else if (strcmp(word, "pause") == 0) step.action.togglePause = true;
+                else ok = false;
+            }
+            if (ok && step.ticks > 0) steps.push_back(step);
+        }
+        fclose(file);
+        if (!ok) fprintf(stderr, "%s:%d: expected \"<ticks> [left|right] [fire] [pause]\"\n", path, lineNumber);
+        return ok && !steps.empty();
+    }
+
+    PlayerAction nextAction(const GameState&) override {
+        const Step& step = steps[current];
+        PlayerAction a = step.action;
+        if (a.togglePause && elapsed > 0) a.togglePause = false;  // A toggle fires once per step
+        if (++elapsed >= step.ticks) {
+            elapsed = 0;
+            current = (current + 1) % steps.size();
+        }
+        return a;
+    }
+
+private:
+    struct Step {
+        int ticks = 0;
+        PlayerAction action;
+    };
+
+    std::vector<Step> steps;
+    size_t current = 0;
+    int elapsed = 0;
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+// Minimal archetype entity-component storage.
+//
+// An archetype is a fixed set of component types stored as one tightly packed
+// array per component (structure of arrays), plus an alive flag. Systems
+// iterate the arrays directly; entities are addressed by index and removed
+// with a stable compaction at the end of the tick, so iteration order (and
+// everything that depends on it) is deterministic.
+//
+// Storage comes from a std::pmr memory resource chosen at construction, so
+// an archetype can live in a scoped arena.
+//
+// Systems declare which components they read and write with SystemAccess so
+// that independent systems can be identified at compile time.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+template <typename... Components>
+class Archetype {
+public:
+    explicit Archetype(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : columns(std::pmr::vector<Components>(resource)...), alive(resource) {}
+
+    size_t size() const { return alive.size(); }
+    bool empty() const { return alive.empty(); }
+
+    size_t spawn(const Components&... values) {
+        pushEach(std::index_sequence_for<Components...>{}, values...);
+        alive.push_back(1);
+        return alive.size() - 1;
+    }
+
+    template <typename C>
+    C* get() { return std::get<std::pmr::vector<C>>(columns).data(); }
+
+    template <typename C>
+    const C* get() const { return std::get<std::pmr::vector<C>>(columns).data(); }
+
+    bool isAlive(size_t i) const { return alive[i] != 0; }
+    void kill(size_t i) { alive[i] = 0; }
+    const uint8_t* aliveFlags() const { return alive.data(); }
+    uint8_t* aliveFlags() { return alive.data(); }
+
+    // Removes killed entities, keeping the survivors in order
+    void compact() {
+        size_t count = alive.size();
+        size_t out = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (alive[i]) {
+                if (out != i) moveEach(std::index_sequence_for<Components...>{}, i, out);
+                out++;
+            }
+        }
+        if (out == count) return;
+        resizeEach(std::index_sequence_for<Components...>{}, out);
+        alive.assign(out, 1);
+    }
+
+    void clear() {
+        resizeEach(std::index_sequence_for<Components...>{}, 0);
+        alive.clear();
+    }
+
+    void reserve(size_t n) {
+        reserveEach(std::index_sequence_for<Components...>{}, n);
+        alive.reserve(n);
+    }
+
+    // Frees all storage back to the memory resource; needed before an
+    // arena the archetype allocates from is released
+    void releaseStorage() {
+        releaseEach(std::index_sequence_for<Components...>{});
+        std::pmr::vector<uint8_t>(alive.get_allocator()).swap(alive);
+    }
+
+private:
+    template <size_t... I>
+    void pushEach(std::index_sequence<I...>, const Components&... values) {
+        (std::get<I>(columns).push_back(values), ...);
+    }
+
+    template <size_t... I>
+    void moveEach(std::index_sequence<I...>, size_t from, size_t to) {
+        ((std::get<I>(columns)[to] = std::get<I>(columns)[from]), ...);
+    }
+
+    template <size_t... I>
+    void resizeEach(std::index_sequence<I...>, size_t n) {
+        (std::get<I>(columns).resize(n), ...);
+    }
+
+    template <size_t... I>
+    void reserveEach(std::index_sequence<I...>, size_t n) {
+        (std::get<I>(columns).reserve(n), ...);
+    }
+
+    template <size_t... I>
+    void releaseEach(std::index_sequence<I...>) {
+        (std::remove_reference_t<decltype(std::get<I>(columns))>(std::get<I>(columns).get_allocator())
+             .swap(std::get<I>(columns)), ...);
+    }
+
+    std::tuple<std::pmr::vector<Components>...> columns;
+    std::pmr::vector<uint8_t> alive;
+};
+
+// Declared component access for a system
+template <typename... Cs> struct Reads {};
+template <typename... Cs> struct Writes {};
+
+template <typename R, typename W> struct SystemAccess;
+
+template <typename... R, typename... W>
+struct SystemAccess<Reads<R...>, Writes<W...>> {
+    template <typename C>
+    static constexpr bool reads() { return (std::is_same<C, R>::value || ...); }
+
+    template <typename C>
+    static constexpr bool writes() { return (std::is_same<C, W>::value || ...); }
+
+    // True if this system writes anything Other touches, or reads anything Other writes
+    template <typename Other>
+    static constexpr bool conflictsWith() {
+        return (Other::template reads<W>() || ...) || (Other::template writes<W>() || ...) ||
+               (Other::template writes<R>() || ...);
+    }
+};
+
+// Two systems may run concurrently only if neither writes what the other uses
+template <typename A, typename B>
+constexpr bool independentSystems() {
+    return !A::template conflictsWith<B>() && !B::template conflictsWith<A>();
+}
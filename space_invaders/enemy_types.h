@@ -0,0 +1,59 @@
+#pragma once
+
+// Enemy archetypes.
+//
+// Everything that differs between enemy types lives in one constexpr table.
+// The formation keeps a bitboard per type, so update and render code runs a
+// kernel per type via forEachEnemyType, with the table entry folded in as
+// compile-time constants instead of branching on the type of each enemy.
+// Adding a type means adding a row here.
+
+#include <type_traits>
+#include <utility>
+
+struct EnemyArchetype {
+    int health;              // Hits to destroy
+    int points;              // Base score, scaled by wave and combo
+    int shootNum, shootDen;  // Scales the wave's base shoot chance
+    float r, g, b;           // Body color
+    bool armored;            // Drawn with a white armor outline
+    int spawnWeight[3];      // Percent of a wave in early (< 3), mid (< 7) and later waves
+};
+
+constexpr EnemyArchetype kEnemyArchetypes[] = {
+    // health points  shoot  color              armored  spawn %
+    {1,      10,     1, 2,  1.0f, 1.0f, 0.0f,  false,   {30, 30, 20}},  // 0: Weak (yellow)
+    {1,      20,     1, 1,  1.0f, 0.0f, 0.0f,  false,   {70, 50, 40}},  // 1: Normal (red)
+    {3,      50,     2, 1,  0.8f, 0.0f, 0.0f,  true,    {0, 20, 40}},   // 2: Tank (maroon)
+};
+
+constexpr int kEnemyTypeCount = (int)(sizeof(kEnemyArchetypes) / sizeof(kEnemyArchetypes[0]));
+
+// Spawn weights of every tier must cover the whole roll
+constexpr bool spawnWeightsComplete(int tier) {
+    int total = 0;
+    for (int t = 0; t < kEnemyTypeCount; t++) total += kEnemyArchetypes[t].spawnWeight[tier];
+    return total == 100;
+}
+static_assert(spawnWeightsComplete(0) && spawnWeightsComplete(1) && spawnWeightsComplete(2),
+              "enemy spawn weights must add up to 100 in every tier");
+
+// Picks the type for a roll in [0, 100)
+inline int enemyTypeForRoll(int tier, int roll) {
+    for (int t = 0; t < kEnemyTypeCount - 1; t++) {
+        roll -= kEnemyArchetypes[t].spawnWeight[tier];
+        if (roll < 0) return t;
+    }
+    return kEnemyTypeCount - 1;
+}
+
+template <typename F, int... Types>
+inline void forEachEnemyTypeImpl(F& fn, std::integer_sequence<int, Types...>) {
+    (fn(std::integral_constant<int, Types>{}), ...);
+}
+
+// Calls fn(std::integral_constant<int, T>) for every enemy type T
+template <typename F>
+inline void forEachEnemyType(F&& fn) {
+    forEachEnemyTypeImpl(fn, std::make_integer_sequence<int, kEnemyTypeCount>{});
+}
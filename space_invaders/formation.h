@@ -0,0 +1,268 @@
+#pragma once
+
+// Enemy formation stored as bitboards.
+//
+// Every enemy sits on a lattice cell (row, col) and all live enemies move
+// together, so the formation is one origin plus, per row, a 64-bit mask for
+// each piece of state. Edge checks, live counts, shooter selection and the
+// end-of-wave test become popcount/ctz/clz over the rows instead of loops
+// over every enemy. Up to 64 columns are supported.
+//
+// Motion is closed-form: each step moves the formation 15 px sideways and
+// bouncing off an edge reverses it and drops it 20 px. Positions stay on the
+// 15 px grid of the anchor, so between two changes of the outermost live
+// columns the formation oscillates between two fixed bounce points and its
+// position after any number of steps is O(1) to compute.
+
+#include <cmath>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "collision.h"
+#include "enemy_types.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+inline int bitCount(uint64_t v) {
+#if defined(_MSC_VER)
+    return (int)__popcnt64(v);
+#else
+    return __builtin_popcountll(v);
+#endif
+}
+
+// Index of the lowest set bit; v must be non-zero
+inline int lowestBit(uint64_t v) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, v);
+    return (int)index;
+#else
+    return __builtin_ctzll(v);
+#endif
+}
+
+// Index of the highest set bit; v must be non-zero
+inline int highestBit(uint64_t v) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, v);
+    return (int)index;
+#else
+    return 63 - __builtin_clzll(v);
+#endif
+}
+
+struct FormationRow {
+    uint64_t alive;
+    uint64_t type[kEnemyTypeCount];  // Exactly one type bit per occupied cell
+    uint64_t hits0, hits1;           // Two-bit counter of hits taken per cell
+};
+
+struct Formation {
+    std::pmr::vector<FormationRow> rows;
+    int cols = 0;
+    float originX = 0;  // Center of cell (0, 0)
+    float originY = 0;
+    float colSpacing = 90;
+    float rowSpacing = 50;
+    float direction = 1.0f;  // +1 right, -1 left; carries over between waves
+
+    // Edge-bounce rule: a step that leaves any live cell with x < minX or
+    // x > maxX reverses direction and drops the formation by dropStep.
+    float minX = 20, maxX = 600;
+    float moveStep = 15, dropStep = 20;
+
+    // Motion anchor, rebuilt whenever the outermost live columns change
+    int anchorLeft = -1, anchorRight = -1;
+    float anchorX = 0, anchorY = 0, anchorDirection = 1.0f;
+    int64_t anchorSteps = 0;           // Steps taken since the anchor
+    int64_t bounceLeft = 0, bounceRight = 0;  // Bounce points, in steps from anchorX
+
+    explicit Formation(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : rows(resource) {}
+
+    void reset(int rowCount, int colCount, float x, float y) {
+        rows.assign(rowCount, FormationRow{});
+        cols = colCount;
+        originX = x;
+        originY = y;
+        anchorLeft = anchorRight = -1;
+    }
+
+    // Frees the row storage back to its memory resource
+    void releaseStorage() {
+        std::pmr::vector<FormationRow>(rows.get_allocator()).swap(rows);
+    }
+
+    void place(int row, int col, int type) {
+        uint64_t bit = 1ull << col;
+        rows[row].alive |= bit;
+        rows[row].type[type] |= bit;
+    }
+
+    float cellX(int col) const { return originX + col * colSpacing; }
+    float cellY(int row) const { return originY + row * rowSpacing; }
+
+    int typeAt(int row, int col) const {
+        uint64_t bit = 1ull << col;
+        for (int t = 0; t < kEnemyTypeCount; t++) {
+            if (rows[row].type[t] & bit) return t;
+        }
+        return 0;
+    }
+
+    int hitsAt(int row, int col) const {
+        return (int)((rows[row].hits0 >> col) & 1) | (int)(((rows[row].hits1 >> col) & 1) << 1);
+    }
+
+    // Records one hit and returns the total taken (saturates at 3)
+    int addHit(int row, int col) {
+        FormationRow& r = rows[row];
+        uint64_t bit = 1ull << col;
+        uint64_t carry = r.hits0 & bit;
+        if ((r.hits1 & carry) == 0) {
+            r.hits0 ^= bit;
+            r.hits1 |= carry;
+        }
+        return hitsAt(row, col);
+    }
+
+    void kill(int row, int col) {
+        uint64_t keep = ~(1ull << col);
+        FormationRow& r = rows[row];
+        r.alive &= keep;
+        for (int t = 0; t < kEnemyTypeCount; t++) r.type[t] &= keep;
+        r.hits0 &= keep;
+        r.hits1 &= keep;
+    }
+
+    // Union of all rows: bit c is set while column c has any live enemy
+    uint64_t liveColumns() const {
+        uint64_t mask = 0;
+        for (const FormationRow& r : rows) mask |= r.alive;
+        return mask;
+    }
+
+    int liveCount() const {
+        int count = 0;
+        for (const FormationRow& r : rows) count += bitCount(r.alive);
+        return count;
+    }
+
+    bool empty() const { return liveColumns() == 0; }
+
+    // Highest-index (lowest on screen) row with a live enemy, or -1
+    int lowestLiveRow() const {
+        for (int row = (int)rows.size() - 1; row >= 0; row--) {
+            if (rows[row].alive) return row;
+        }
+        return -1;
+    }
+
+    // Finds the first live cell whose 30x30 box the segment (x0, y0) -> (x1, y1)
+    // enters. Only cells within the segment's bounding box are tested.
+    bool sweep(float x0, float y0, float x1, float y1, int& row, int& col) const {
+        float left = (x0 < x1 ? x0 : x1) - 15, right = (x0 < x1 ? x1 : x0) + 15;
+        float top = (y0 < y1 ? y0 : y1) - 15, bottom = (y0 < y1 ? y1 : y0) + 15;
+        int c0 = (int)std::ceil((left - originX) / colSpacing);
+        int c1 = (int)std::floor((right - originX) / colSpacing);
+        int r0 = (int)std::ceil((top - originY) / rowSpacing);
+        int r1 = (int)std::floor((bottom - originY) / rowSpacing);
+        if (c0 < 0) c0 = 0;
+        if (r0 < 0) r0 = 0;
+        if (c1 >= cols) c1 = cols - 1;
+        if (r1 >= (int)rows.size()) r1 = (int)rows.size() - 1;
+        if (c0 > c1 || r0 > r1) return false;
+
+        uint64_t span = (c1 - c0 == 63) ? ~0ull : (((1ull << (c1 - c0 + 1)) - 1) << c0);
+        float best = 2.0f;
+        for (int r = r0; r <= r1; r++) {
+            uint64_t candidates = rows[r].alive & span;
+            float ey = cellY(r);
+            while (candidates) {
+                int c = lowestBit(candidates);
+                candidates &= candidates - 1;
+                float ex = cellX(c);
+                float t;
+                if (segmentHitsBox(x0, y0, x1, y1, ex - 15, ey - 15, ex + 15, ey + 15, t) && t < best) {
+                    best = t;
+                    row = r;
+                    col = c;
+                }
+            }
+        }
+        return best <= 1.0f;
+    }
+
+    // Moves one step; returns true if the formation bounced and dropped
+    bool step() {
+        float y = originY;
+        advance(1);
+        return originY != y;
+    }
+
+    // Jumps the formation n steps ahead in O(1)
+    void advance(int64_t n) {
+        uint64_t live = liveColumns();
+        if (!live) return;
+        if (lowestBit(live) != anchorLeft || highestBit(live) != anchorRight) rebase(live);
+        anchorSteps += n;
+        positionAt(anchorSteps);
+    }
+
+private:
+    void rebase(uint64_t live) {
+        anchorLeft = lowestBit(live);
+        anchorRight = highestBit(live);
+        anchorX = originX;
+        anchorY = originY;
+        anchorDirection = direction;
+        anchorSteps = 0;
+
+        // Origin limits for the current extents, then the grid points just past them
+        double lo = minX - anchorLeft * colSpacing;
+        double hi = maxX - anchorRight * colSpacing;
+        bounceRight = (int64_t)std::floor((hi - anchorX) / moveStep) + 1;
+        bounceLeft = (int64_t)std::ceil((lo - anchorX) / moveStep) - 1;
+    }
+
+    void positionAt(int64_t n) {
+        // Steps to the first bounce and between later ones. A formation that
+        // is outside the edges and would still be after its next step (e.g.
+        // wider than the field) bounces in place every step.
+        int64_t first = anchorDirection > 0 ? bounceRight : -bounceLeft;
+        int64_t leg = bounceRight - bounceLeft;
+        int64_t next = anchorDirection > 0 ? 1 : -1;
+        bool outside = bounceLeft >= 0 || bounceRight <= 0;
+        bool nextOutside = next <= bounceLeft || next >= bounceRight;
+        if (outside && nextOutside) first = leg = 1;
+
+        int64_t offset;
+        int64_t bounces;
+        float dir;
+        if (n < first) {
+            offset = n * (int64_t)anchorDirection;
+            bounces = 0;
+            dir = anchorDirection;
+        } else {
+            // Full legs between the two bounce points after the first bounce
+            int64_t t = n - first;
+            int64_t legs = t / leg;
+            int64_t r = t % leg;
+            int64_t firstBounce = anchorDirection > 0 ? first : -first;
+            bool backwards = (legs % 2) == 0;  // Heading away from the first bounce point
+            int64_t start = backwards ? firstBounce : (anchorDirection > 0 ? firstBounce - leg : firstBounce + leg);
+            dir = backwards ? -anchorDirection : anchorDirection;
+            offset = start + r * (int64_t)dir;
+            bounces = 1 + legs;
+        }
+
+        originX = anchorX + offset * moveStep;
+        originY = anchorY + bounces * dropStep;
+        direction = dir;
+    }
+};
@@ -0,0 +1,413 @@
+#pragma once
+
+// Asynchronous frame capture.
+//
+// Each captured frame is read back into a ring of pixel buffer objects with
+// glReadPixels (which returns immediately when a PBO is bound) and fenced.
+// Every frame polls the oldest fences without waiting: a finished readback
+// is mapped, copied into a pooled buffer and handed to a writer thread that
+// encodes it as a Y4M stream or a PNG sequence, while one the GPU hasn't
+// finished is left for a later frame. Only when every PBO is still in
+// flight is a frame dropped. The game thread never waits on the readback
+// and never allocates per frame.
+
+#include <glad/gl.h>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+class FrameCapture {
+public:
+    enum class Format { Y4M, PNG };
+
+    ~FrameCapture() { stop(); }
+
+    // Format is picked from the extension: ".y4m" writes one video stream,
+    // anything else is a PNG sequence. A PNG path may contain one printf-style
+    // frame index (e.g. "shots/frame_%05d.png", "%%" for a literal percent);
+    // otherwise one is inserted before the extension. Any other conversion
+    // is rejected, since the path is used as a format string.
+    bool start(const std::string& path, int width, int height, int fps) {
+        if (running) return false;
+
+        this->width = width;
+        this->height = height;
+        format = endsWith(path, ".y4m") ? Format::Y4M : Format::PNG;
+        pattern = path;
+        if (format == Format::PNG && path.find('%') == std::string::npos) {
+            size_t dot = path.rfind('.');
+            pattern = (dot == std::string::npos) ? path + "_%05d.png"
+                                                 : path.substr(0, dot) + "_%05d" + path.substr(dot);
+        }
+        if (format == Format::PNG && !isFramePattern(pattern)) {
+            fprintf(stderr, "Capture: %s needs exactly one %%d-style frame number (use %%%% for a literal %%)\n",
+                    path.c_str());
+            return false;
+        }
+
+        if (format == Format::Y4M) {
+            video = fopen(path.c_str(), "wb");
+            if (!video) {
+                fprintf(stderr, "Capture: cannot open %s\n", path.c_str());
+                return false;
+            }
+            fprintf(video, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps);
+        }
+
+        size_t frameBytes = (size_t)width * height * 4;
+        glGenBuffers(kPboCount, pbos);
+        for (int i = 0; i < kPboCount; i++) {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[i]);
+            glBufferData(GL_PIXEL_PACK_BUFFER, frameBytes, nullptr, GL_STREAM_READ);
+            fences[i] = nullptr;
+        }
+        issued = 0;
+        collected = 0;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        // All encoding scratch is sized up front so the writer never allocates either
+        pool.assign(kPoolSize, std::vector<uint8_t>(frameBytes));
+        freeSlots.clear();
+        queued.clear();
+        freeSlots.reserve(kPoolSize);
+        queued.reserve(kPoolSize);
+        for (int i = 0; i < kPoolSize; i++) freeSlots.push_back(i);
+        encodeScratch.resize(format == Format::Y4M ? (size_t)width * height * 3 / 2 + 4
+                                                   : (size_t)(width * 3 + 1) * height);
+        deflateScratch.resize(encodeScratch.size() + encodeScratch.size() / 65535 * 5 + 64);
+
+        frameIndex = 0;
+        framesWritten = 0;
+        framesDropped = 0;
+        deferrals = 0;
+        stopping = false;
+        running = true;
+        writer = std::thread(&FrameCapture::writerLoop, this);
+        printf("Capturing %dx%d frames to %s\n", width, height, pattern.c_str());
+        return true;
+    }
+
+    // Call once per rendered frame, after drawing and before glfwSwapBuffers.
+    void capture() {
+        if (!running) return;
+
+        // Hand off finished readbacks, oldest first so frames stay in order.
+        // The swap flushes each fence, so a pending one signals on its own.
+        while (collected < issued && collect(collected % kPboCount, false)) collected++;
+        if (collected < issued) deferrals++;
+
+        if (issued - collected == kPboCount) {
+            framesDropped++;  // Every PBO is still being read back
+        } else {
+            // Kick off this frame's readback; it completes asynchronously into the PBO
+            int pbo = (int)(issued % kPboCount);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[pbo]);
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            fences[pbo] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            pboFrames[pbo] = frameIndex;
+            issued++;
+        }
+        frameIndex++;
+    }
+
+    // Waits for the readbacks still in flight and for the writer to drain.
+    void stop() {
+        if (!running) return;
+
+        for (; collected < issued; collected++) collect(collected % kPboCount, true);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+
+        glDeleteBuffers(kPboCount, pbos);
+        if (video) {
+            fclose(video);
+            video = nullptr;
+        }
+        running = false;
+        printf("\nCapture: %llu frames written, %llu dropped, %llu frames deferred a readback\n",
+               (unsigned long long)framesWritten, (unsigned long long)framesDropped,
+               (unsigned long long)deferrals);
+    }
+
+    bool isRunning() const { return running; }
+
+private:
+    static const int kPboCount = 3;
+    static const int kPoolSize = 8;
+
+    struct QueuedFrame {
+        int slot;
+        uint64_t index;
+    };
+
+    // Maps a PBO whose readback has finished and queues its frame. Without
+    // `wait` it only polls the fence and returns false, leaving the PBO, if
+    // the GPU isn't done; with it (at shutdown) it waits up to a second.
+    bool collect(int pbo, bool wait) {
+        GLenum status = wait ? glClientWaitSync(fences[pbo], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000)
+                             : glClientWaitSync(fences[pbo], 0, 0);
+        if (status == GL_TIMEOUT_EXPIRED && !wait) return false;
+        glDeleteSync(fences[pbo]);
+        fences[pbo] = nullptr;
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+            framesDropped++;
+            return true;
+        }
+        uint64_t index = pboFrames[pbo];
+
+        int slot = -1;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!freeSlots.empty()) {
+                slot = freeSlots.back();
+                freeSlots.pop_back();
+            }
+        }
+        if (slot < 0) {
+            // Writer is behind: drop rather than block the game thread
+            framesDropped++;
+            return true;
+        }
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[pbo]);
+        const void* pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+        if (pixels) {
+            memcpy(pool[slot].data(), pixels, pool[slot].size());
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (pixels) queued.push_back({slot, index});
+            else freeSlots.push_back(slot);
+        }
+        wake.notify_one();
+        return true;
+    }
+
+    void writerLoop() {
+        for (;;) {
+            QueuedFrame frame;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stopping || !queued.empty(); });
+                if (queued.empty()) return;
+                frame = queued.front();
+                queued.erase(queued.begin());
+            }
+
+            if (format == Format::Y4M) writeY4mFrame(pool[frame.slot].data());
+            else writePng(pool[frame.slot].data(), frame.index);
+            framesWritten++;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            freeSlots.push_back(frame.slot);
+        }
+    }
+
+    // GL rows are bottom-up, both output formats are top-down
+    const uint8_t* rowTopDown(const uint8_t* rgba, int y) const {
+        return rgba + (size_t)(height - 1 - y) * width * 4;
+    }
+
+    void writeY4mFrame(const uint8_t* rgba) {
+        uint8_t* yPlane = encodeScratch.data();
+        uint8_t* uPlane = yPlane + width * height;
+        uint8_t* vPlane = uPlane + (width / 2) * (height / 2);
+
+        // Full-range BT.601, chroma averaged over each 2x2 block
+        for (int y = 0; y < height; y++) {
+            const uint8_t* row = rowTopDown(rgba, y);
+            for (int x = 0; x < width; x++) {
+                const uint8_t* p = row + x * 4;
+                yPlane[y * width + x] = (uint8_t)((77 * p[0] + 150 * p[1] + 29 * p[2]) >> 8);
+            }
+        }
+        for (int y = 0; y < height / 2; y++) {
+            const uint8_t* row0 = rowTopDown(rgba, y * 2);
+            const uint8_t* row1 = rowTopDown(rgba, y * 2 + 1);
+            for (int x = 0; x < width / 2; x++) {
+                int r = 0, g = 0, b = 0;
+                const uint8_t* quad[4] = {row0 + x * 8, row0 + x * 8 + 4, row1 + x * 8, row1 + x * 8 + 4};
+                for (const uint8_t* p : quad) {
+                    r += p[0];
+                    g += p[1];
+                    b += p[2];
+                }
+                r /= 4; g /= 4; b /= 4;
+                uPlane[y * (width / 2) + x] = (uint8_t)((-43 * r - 85 * g + 128 * b + 32768) >> 8);
+                vPlane[y * (width / 2) + x] = (uint8_t)((128 * r - 107 * g - 21 * b + 32768) >> 8);
+            }
+        }
+
+        fputs("FRAME\n", video);
+        fwrite(encodeScratch.data(), 1, (size_t)width * height + 2 * (width / 2) * (height / 2), video);
+    }
+
+    // True if the pattern's only conversion is one "%d" with optional zero
+    // flag and width, besides "%%" escapes
+    static bool isFramePattern(const std::string& pattern) {
+        int conversions = 0;
+        for (size_t i = 0; i < pattern.size(); i++) {
+            if (pattern[i] != '%') continue;
+            if (++i < pattern.size() && pattern[i] == '%') continue;
+            while (i < pattern.size() && pattern[i] >= '0' && pattern[i] <= '9') i++;
+            if (i == pattern.size() || pattern[i] != 'd') return false;
+            conversions++;
+        }
+        return conversions == 1;
+    }
+
+    // Minimal PNG writer: RGB8, filter 0, stored (uncompressed) deflate blocks.
+    // Larger files than zlib would give, but no dependency and trivially fast.
+    void writePng(const uint8_t* rgba, uint64_t index) {
+        char name[512];
+        snprintf(name, sizeof(name), pattern.c_str(), (int)index);
+        FILE* file = fopen(name, "wb");
+        if (!file) return;
+
+        size_t rawSize = (size_t)(width * 3 + 1) * height;
+        uint8_t* raw = encodeScratch.data();
+        for (int y = 0; y < height; y++) {
+            const uint8_t* row = rowTopDown(rgba, y);
+            uint8_t* out = raw + (size_t)y * (width * 3 + 1);
+            *out++ = 0;
+            for (int x = 0; x < width; x++) {
+                *out++ = row[x * 4 + 0];
+                *out++ = row[x * 4 + 1];
+                *out++ = row[x * 4 + 2];
+            }
+        }
+
+        uint8_t* z = deflateScratch.data();
+        size_t zSize = 0;
+        z[zSize++] = 0x78;
+        z[zSize++] = 0x01;
+        for (size_t offset = 0; offset < rawSize; offset += 65535) {
+            size_t len = rawSize - offset < 65535 ? rawSize - offset : 65535;
+            z[zSize++] = (offset + len == rawSize) ? 1 : 0;
+            z[zSize++] = (uint8_t)(len & 0xff);
+            z[zSize++] = (uint8_t)(len >> 8);
+            z[zSize++] = (uint8_t)(~len & 0xff);
+            z[zSize++] = (uint8_t)((~len >> 8) & 0xff);
+            memcpy(z + zSize, raw + offset, len);
+            zSize += len;
+        }
+        uint32_t adler = adler32(raw, rawSize);
+        putBigEndian(z + zSize, adler);
+        zSize += 4;
+
+        static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+        fwrite(signature, 1, sizeof(signature), file);
+
+        uint8_t header[13];
+        putBigEndian(header, (uint32_t)width);
+        putBigEndian(header + 4, (uint32_t)height);
+        header[8] = 8;   // bit depth
+        header[9] = 2;   // truecolor
+        header[10] = 0;  // deflate
+        header[11] = 0;  // adaptive filtering
+        header[12] = 0;  // no interlace
+        writeChunk(file, "IHDR", header, sizeof(header));
+        writeChunk(file, "IDAT", z, zSize);
+        writeChunk(file, "IEND", nullptr, 0);
+        fclose(file);
+    }
+
+    static void writeChunk(FILE* file, const char* type, const uint8_t* data, size_t size) {
+        uint8_t word[4];
+        putBigEndian(word, (uint32_t)size);
+        fwrite(word, 1, 4, file);
+        fwrite(type, 1, 4, file);
+        if (size) fwrite(data, 1, size, file);
+        uint32_t crc = crc32((const uint8_t*)type, 4, 0xffffffffu);
+        crc = crc32(data, size, crc) ^ 0xffffffffu;
+        putBigEndian(word, crc);
+        fwrite(word, 1, 4, file);
+    }
+
+    static uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc) {
+        static uint32_t table[256];
+        static bool tableReady = false;
+        if (!tableReady) {
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++) c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                table[n] = c;
+            }
+            tableReady = true;
+        }
+        for (size_t i = 0; i < size; i++) crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        return crc;
+    }
+
+    static uint32_t adler32(const uint8_t* data, size_t size) {
+        uint32_t a = 1, b = 0;
+        while (size > 0) {
+            size_t block = size < 5552 ? size : 5552;
+            size -= block;
+            while (block--) {
+                a += *data++;
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+        }
+        return (b << 16) | a;
+    }
+
+    static void putBigEndian(uint8_t* out, uint32_t value) {
+        out[0] = (uint8_t)(value >> 24);
+        out[1] = (uint8_t)(value >> 16);
+        out[2] = (uint8_t)(value >> 8);
+        out[3] = (uint8_t)value;
+    }
+
+    static bool endsWith(const std::string& s, const char* suffix) {
+        size_t n = strlen(suffix);
+        return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+    }
+
+    int width = 0;
+    int height = 0;
+    Format format = Format::Y4M;
+    std::string pattern;
+    FILE* video = nullptr;
+
+    GLuint pbos[kPboCount] = {};
+    GLsync fences[kPboCount] = {};
+    uint64_t pboFrames[kPboCount] = {};  // Frame each PBO is reading back
+    uint64_t issued = 0;                 // Readbacks started; PBO i % kPboCount holds the i-th
+    uint64_t collected = 0;              // Readbacks handed off (or dropped), oldest first
+    uint64_t frameIndex = 0;
+    bool running = false;
+
+    // Shared with the writer thread
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<std::vector<uint8_t>> pool;
+    std::vector<int> freeSlots;
+    std::vector<QueuedFrame> queued;
+    bool stopping = false;
+
+    // Writer thread only
+    std::thread writer;
+    std::vector<uint8_t> encodeScratch;
+    std::vector<uint8_t> deflateScratch;
+    uint64_t framesWritten = 0;
+
+    uint64_t framesDropped = 0;
+    uint64_t deferrals = 0;  // Frames that left a pending readback for later
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+// Bounds how many frames the driver may queue ahead of the GPU.
+//
+// A fence goes in behind every swap. Before simulating the next frame the
+// pacer waits until no more than maxFramesInFlight - 1 earlier frames are
+// still unfinished: with 1 the game waits for frame N-1 to finish before
+// starting frame N, with 2 for frame N-2. Input is then sampled closer to
+// the frame that displays it, at the cost of some CPU/GPU overlap.
+
+#include <glad/gl.h>
+#include <chrono>
+
+class FramePacer {
+public:
+    static const int kMaxFramesInFlight = 3;
+
+    // 0 disables pacing
+    explicit FramePacer(int maxFramesInFlight)
+        : maxInFlight(maxFramesInFlight < 0 ? 0 : maxFramesInFlight > kMaxFramesInFlight ? kMaxFramesInFlight
+                                                                                          : maxFramesInFlight) {}
+
+    ~FramePacer() { release(); }
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    bool enabled() const { return maxInFlight > 0; }
+
+    // Call right after glfwSwapBuffers
+    void frameSubmitted() {
+        if (!maxInFlight) return;
+        fences[(head + pending) % kMaxFramesInFlight] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        pending++;
+    }
+
+    // Call before starting a frame; returns the seconds spent waiting
+    double waitForQueue() {
+        if (!maxInFlight || pending < maxInFlight) return 0.0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        while (pending >= maxInFlight) {
+            // A second is far beyond any real frame; give up on a lost fence rather than hang
+            glClientWaitSync(fences[head], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+            retireOldest();
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Deletes outstanding fences; call while the context is still current
+    void release() {
+        while (pending > 0) retireOldest();
+    }
+
+private:
+    void retireOldest() {
+        glDeleteSync(fences[head]);
+        head = (head + 1) % kMaxFramesInFlight;
+        pending--;
+    }
+
+    int maxInFlight;
+    GLsync fences[kMaxFramesInFlight] = {};
+    int head = 0, pending = 0;
+};
@@ -0,0 +1,404 @@
+// Game systems (see game_state.h)
+
+#include "game_state.h"
+
+#include "audio_mixer.h"
+
+GameState::GameState(uint64_t seed, size_t particleCapacity)
+    : particles(particleCapacity), jobs(nullptr), audio(nullptr) {
+    // Room for a typical fight, so bullets don't reallocate mid-game
+    playerBullets.reserve(256);
+    enemyBullets.reserve(1024);
+    reset(seed);
+}
+
+void GameState::reset(uint64_t seed) {
+    playerX = 320;
+    playerY = 420;
+    playerBullets.clear();
+    enemyBullets.clear();
+    particles.clear();
+    enemies.direction = 1.0f;
+    score = 0;
+    lives = 3;
+    wave = 1;
+    comboCounter = 0;
+    comboMultiplier = 1.0f;
+    enemyMoveTimer = 0;
+    gameOver = false;
+    paused = false;
+    gameSpeed = 1.0f;
+    shieldActive = rapidFireActive = multiShotActive = slowMotionActive = 0;
+    shotCooldown = 0;
+    tick = 0;
+    lastDt = 0;
+    rngSeed = seed * 0x9e3779b97f4a7c15ull + 1;
+    shootTimer = 0;
+    marchStep = 0;
+    spawnWave();
+}
+
+void GameState::spawnWave() {
+    // Start the wave from an empty arena
+    enemies.releaseStorage();
+    powerUps.releaseStorage();
+    waveArena.release();
+    
+    // Increase difficulty with each wave
+    int rows = 2 + (wave / 2);
+    int cols = 6;
+    enemies.reset(rows, cols, 50, 30);
+    powerUps.reserve(rows * cols);  // At most one drop per enemy
+    bunkers.reset();
+    
+    // Determine enemy types based on wave: early waves are mostly normal
+    // enemies, later waves bring more tanks
+    int tier = wave < 3 ? 0 : (wave < 7 ? 1 : 2);
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            enemies.place(row, col, enemyTypeForRoll(tier, rollPercent(rngSeed, wave, kStreamEnemyType,
+                                                                        (uint32_t)(row * cols + col))));
+        }
+    }
+}
+
+float GameState::formationStepInterval() const {
+    float moveSpeed = 1.0f - (wave * 0.1f);  // Gets faster with each wave
+    return moveSpeed < 0.3f ? 0.3f : moveSpeed;
+}
+
+void GameState::update(float dt) {
+    if (gameOver || paused) return;
+    
+    tickArena.release();
+    formationSystem(dt);
+    movementSystem(dt);
+    particleSystem(dt);
+    bunkerSystem();
+    enemyHitSystem();
+    pickupSystem();
+    playerHitSystem();
+    timerSystem(dt);
+    firingSystem(dt);
+    waveSystem();
+    cleanupSystem();
+    tick++;
+    if (audio) audio->advanceTick();
+}
+
+IndexList* GameState::allocChunkLists(size_t n) {
+    size_t chunks = (n + kParallelGrain - 1) / kParallelGrain;
+    IndexList* lists = static_cast<IndexList*>(tickArena.allocate(chunks * sizeof(IndexList), alignof(IndexList)));
+    for (size_t c = 0; c < chunks; c++) {
+        size_t len = std::min(kParallelGrain, n - c * kParallelGrain);
+        lists[c].items = static_cast<uint32_t*>(tickArena.allocate(len * sizeof(uint32_t), alignof(uint32_t)));
+        lists[c].count = 0;
+    }
+    return lists;
+}
+
+void GameState::formationSystem(float dt) {
+    // Move enemies with difficulty scaling
+    enemyMoveTimer += dt;
+    float moveSpeed = formationStepInterval();
+    
+    if (enemyMoveTimer > moveSpeed && !enemies.empty()) {
+        enemyMoveTimer = 0;
+        playSound((SoundId)(kSoundMarch0 + marchStep++ % 4), 320, 0.6f);
+        
+        // Hit an edge: the formation reversed and dropped
+        if (enemies.step() && enemies.cellY(enemies.lowestLiveRow()) > 400) {
+            gameOver = true;
+        }
+    }
+}
+
+void GameState::movementSystem(float dt) {
+    forChunks(playerBullets.size(), [&](size_t begin, size_t end) {
+        integrate(playerBullets, begin, end, dt);
+    });
+    forChunks(enemyBullets.size(), [&](size_t begin, size_t end) {
+        integrate(enemyBullets, begin, end, dt);
+    });
+    forChunks(powerUps.size(), [&](size_t begin, size_t end) {
+        integrate(powerUps, begin, end, dt);
+    });
+    lastDt = dt;
+}
+
+void GameState::particleSystem(float dt) {
+    particles.update(dt);
+}
+
+void GameState::bunkerSystem() {
+    // Enemies low enough to reach the band plough through it
+    for (int row = 0; row < (int)enemies.rows.size(); row++) {
+        float ey = enemies.cellY(row);
+        if (ey + 15 < kBunkerTop || ey - 15 >= kBunkerBottom) continue;
+        uint64_t mask = enemies.rows[row].alive;
+        while (mask) {
+            float ex = enemies.cellX(lowestBit(mask));
+            mask &= mask - 1;
+            bunkers.clearBox(ex - 15, ey - 15, ex + 15, ey + 15);
+        }
+    }
+    
+    // Shots from either side chip the bunkers, the player's included
+    bulletsHitBunkers(playerBullets, -8, true);
+    bulletsHitBunkers(enemyBullets, 8, false);
+}
+
+void GameState::bulletsHitBunkers(Bullets& bullets, float tip, bool fromPlayer) {
+    const Position* pos = bullets.get<Position>();
+    const Velocity* vel = bullets.get<Velocity>();
+    
+    // Find the bullets that reach solid cells, collecting them per chunk.
+    // Most are nowhere near the band and drop out on its y range.
+    IndexList* blocked = allocChunkLists(bullets.size());
+    forChunks(bullets.size(), [&](size_t begin, size_t end) {
+        IndexList& hits = blocked[begin / kParallelGrain];
+        for (size_t i = begin; i < end; i++) {
+            if (bullets.isAlive(i) &&
+                bunkers.sweep(pos[i].x, 2, pos[i].y + tip - vel[i].dy * lastDt, pos[i].y + tip) >= 0) {
+                hits.items[hits.count++] = (uint32_t)i;
+            }
+        }
+    });
+    
+    // Erode in index order. A crater can clear the way for a later bullet
+    // found above, so each one sweeps again against the current mask.
+    size_t chunks = (bullets.size() + kParallelGrain - 1) / kParallelGrain;
+    for (size_t c = 0; c < chunks; c++) {
+        for (size_t h = 0; h < blocked[c].count; h++) {
+            uint32_t i = blocked[c].items[h];
+            int row = bunkers.sweep(pos[i].x, 2, pos[i].y + tip - vel[i].dy * lastDt, pos[i].y + tip);
+            if (row < 0) continue;
+            bullets.kill(i);
+            bunkers.erode(pos[i].x, row, fromPlayer);
+            playSound(kSoundHit, pos[i].x, 0.4f);
+            particles.emit(pos[i].x, Bunkers::cellY(row), 8, 80.0f, 0.3f, 0.0f, 1.0f, 0.0f);
+        }
+    }
+}
+
+void GameState::enemyHitSystem() {
+    const Position* pos = playerBullets.get<Position>();
+    const Velocity* vel = playerBullets.get<Velocity>();
+    for (size_t i = 0; i < playerBullets.size(); i++) {
+        // Check collision with enemies along the path covered this tick
+        int row, col;
+        if (!playerBullets.isAlive(i) ||
+            !enemies.sweep(pos[i].x - vel[i].dx * lastDt, pos[i].y - vel[i].dy * lastDt,
+                           pos[i].x, pos[i].y, row, col)) continue;
+        
+        playerBullets.kill(i);
+        const EnemyArchetype& archetype = kEnemyArchetypes[enemies.typeAt(row, col)];
+        
+        // Check if enemy defeated
+        float ex = enemies.cellX(col), ey = enemies.cellY(row);
+        if (enemies.addHit(row, col) >= archetype.health) {
+            enemies.kill(row, col);
+            particles.emit(ex, ey, 48, 180.0f, 0.8f, archetype.r, archetype.g, archetype.b);
+            playSound(kSoundExplosion, ex);
+            comboCounter++;
+            
+            // Update combo multiplier
+            if (comboCounter >= 20) comboMultiplier = 2.0f;
+            else if (comboCounter >= 10) comboMultiplier = 1.5f;
+            else if (comboCounter >= 5) comboMultiplier = 1.25f;
+            else comboMultiplier = 1.0f;
+            
+            // Calculate score with combo multiplier
+            score += (int)(archetype.points * wave * comboMultiplier);
+            
+            // Spawn power-up (20% chance)
+            uint32_t cell = (uint32_t)(row * enemies.cols + col);
+            if (rollPercent(rngSeed, tick, kStreamDrop, cell) < 20) {
+                int kind = rollPercent(rngSeed, tick, kStreamDropKind, cell) % 4;  // Random power-up type
+                powerUps.spawn({ex, ey}, {0.0f, 60.0f}, {kind});
+            }
+        } else {
+            // Armor absorbed the hit: sparks where the bullet struck
+            particles.emit(pos[i].x, ey + 15, 12, 120.0f, 0.3f, 1.0f, 0.9f, 0.5f);
+            playSound(kSoundHit, pos[i].x, 0.7f);
+        }
+    }
+}
+
+void GameState::pickupSystem() {
+    const Position* pos = powerUps.get<Position>();
+    const Velocity* vel = powerUps.get<Velocity>();
+    const PowerUpKind* kind = powerUps.get<PowerUpKind>();
+    
+    // Check collision with player, collecting hits per chunk
+    IndexList* picked = allocChunkLists(powerUps.size());
+    forChunks(powerUps.size(), [&](size_t begin, size_t end) {
+        IndexList& hits = picked[begin / kParallelGrain];
+        for (size_t i = begin; i < end; i++) {
+            float t;
+            if (powerUps.isAlive(i) &&
+                segmentHitsBox(pos[i].x - vel[i].dx * lastDt, pos[i].y - vel[i].dy * lastDt, pos[i].x, pos[i].y,
+                               playerX - 20, playerY - 25, playerX + 20, playerY + 20, t)) {
+                hits.items[hits.count++] = (uint32_t)i;
+            }
+        }
+    });
+    
+    // Apply in index order so the result never depends on scheduling
+    size_t chunks = (powerUps.size() + kParallelGrain - 1) / kParallelGrain;
+    for (size_t c = 0; c < chunks; c++) {
+        for (size_t h = 0; h < picked[c].count; h++) {
+            uint32_t i = picked[c].items[h];
+            powerUps.kill(i);
+            
+            // Apply power-up based on type
+            switch (kind[i].type) {
+                case 0: shieldActive = 1.0f; break;        // Shield: 1 unit
+                case 1: rapidFireActive = 8.0f; break;     // Rapid fire: 8 seconds
+                case 2: multiShotActive = 10.0f; break;    // Multi-shot: 10 seconds
+                case 3: slowMotionActive = 5.0f; break;    // Slow motion: 5 seconds
+            }
+            
+            score += 100;  // Bonus for collecting power-up
+            playSound(kSoundPowerUp, pos[i].x);
+        }
+    }
+}
+
+void GameState::playerHitSystem() {
+    const Position* pos = enemyBullets.get<Position>();
+    const Velocity* vel = enemyBullets.get<Velocity>();
+    for (size_t i = 0; i < enemyBullets.size(); i++) {
+        // Check collision with player along the path covered this tick
+        float t;
+        if (enemyBullets.isAlive(i) &&
+            segmentHitsBox(pos[i].x - vel[i].dx * lastDt, pos[i].y - vel[i].dy * lastDt, pos[i].x, pos[i].y,
+                           playerX - 20, playerY - 20, playerX + 20, playerY + 20, t)) {
+            enemyBullets.kill(i);
+            
+            // Check if shield is active
+            if (shieldActive > 0) {
+                shieldActive = 0;  // Shield blocks one hit
+                playSound(kSoundHit, playerX);
+            } else {
+                playSound(kSoundPlayerExplosion, playerX);
+                comboCounter = 0;  // Reset combo on hit
+                comboMultiplier = 1.0f;
+                lives--;
+                if (lives <= 0) gameOver = true;
+            }
+        }
+    }
+}
+
+void GameState::timerSystem(float dt) {
+    // Update power-up timers
+    if (shieldActive > 0) shieldActive -= dt;
+    if (rapidFireActive > 0) rapidFireActive -= dt;
+    if (multiShotActive > 0) multiShotActive -= dt;
+    if (slowMotionActive > 0) slowMotionActive -= dt;
+    if (shotCooldown > 0) shotCooldown -= dt;
+}
+
+void GameState::firingSystem(float dt) {
+    // Enemy shooting - more aggressive at higher waves
+    shootTimer += dt;
+    
+    // Adjust shoot interval based on slow motion
+    float shootInterval = (0.5f / wave) / (slowMotionActive > 0 ? 2.0f : 1.0f);
+    shootInterval = shootInterval < 0.1f ? 0.1f : shootInterval;
+    
+    if (shootTimer > shootInterval) {
+        shootTimer = 0;
+        
+        // Only the lowest live enemy in each column has a clear shot
+        int baseChance = 5 + wave * 2;
+        uint64_t covered = 0;
+        for (int row = (int)enemies.rows.size() - 1; row >= 0; row--) {
+            const FormationRow& r = enemies.rows[row];
+            uint64_t shooters = r.alive & ~covered;
+            covered |= r.alive;
+            if (!shooters) continue;
+            
+            forEachEnemyType([&](auto type) {
+                // Per-type chance is a compile-time scale of the wave's base
+                constexpr const EnemyArchetype& archetype = kEnemyArchetypes[decltype(type)::value];
+                int shootChance = baseChance * archetype.shootNum / archetype.shootDen;
+                
+                uint64_t mask = shooters & r.type[decltype(type)::value];
+                while (mask) {
+                    int col = lowestBit(mask);
+                    mask &= mask - 1;
+                    if (rollPercent(rngSeed, tick, kStreamEnemyFire, (uint32_t)col) < shootChance) {
+                        enemyBullets.spawn({enemies.cellX(col), enemies.cellY(row) + 20}, {0.0f, 150.0f});
+                    }
+                }
+            });
+        }
+    }
+}
+
+void GameState::waveSystem() {
+    // Check if all enemies defeated
+    if (enemies.empty()) {
+        // Next wave!
+        wave++;
+        spawnWave();
+    }
+}
+
+void GameState::cleanupSystem() {
+    // Drop whatever left the screen, then clean up inactive bullets and power-ups
+    forChunks(playerBullets.size(), [this](size_t begin, size_t end) {
+        cull(playerBullets, begin, end, 0, true);
+    });
+    forChunks(enemyBullets.size(), [this](size_t begin, size_t end) {
+        cull(enemyBullets, begin, end, 480, false);
+    });
+    forChunks(powerUps.size(), [this](size_t begin, size_t end) {
+        cull(powerUps, begin, end, 480, false);
+    });
+    
+    playerBullets.compact();
+    enemyBullets.compact();
+    powerUps.compact();
+}
+
+void GameState::handleInput(const PlayerAction& action) {
+    if (action.togglePause) paused = !paused;
+    if (paused) return;  // Don't process other input while paused
+    
+    if (action.move < 0) {
+        playerX -= 7.0f;  // Slightly faster movement
+        if (playerX < 20) playerX = 20;
+    }
+    if (action.move > 0) {
+        playerX += 7.0f;
+        if (playerX > 620) playerX = 620;
+    }
+    if (action.fire) {
+        // Shoot - with power-up support. The cooldown runs on simulation
+        // time so fire rate doesn't change under fast-forward.
+        if (shotCooldown <= 0) {
+            // Adjust cooldown based on rapid fire power-up
+            shotCooldown = 0.2f;
+            if (rapidFireActive > 0) shotCooldown = 0.1f;  // 2x fire rate
+            
+            // Multi-shot mode: 3 bullets
+            Velocity up = {0.0f, -300.0f};  // Slightly faster bullets
+            playSound(kSoundShot, playerX, 0.5f);
+            if (multiShotActive > 0) {
+                playerBullets.spawn({playerX, playerY - 20}, up);       // Center bullet
+                playerBullets.spawn({playerX - 15, playerY - 20}, up);  // Left bullet
+                playerBullets.spawn({playerX + 15, playerY - 20}, up);  // Right bullet
+            } else {
+                // Normal single shot
+                playerBullets.spawn({playerX, playerY - 20}, up);
+            }
+        }
+    }
+}
+
+void GameState::playSound(SoundId id, float x, float volume) {
+    if (audio) audio->play(id, volume, x / 320.0f - 1.0f);
+}
@@ -0,0 +1,233 @@
+#pragma once
+
+// The simulation: one game's state and the systems that advance it.
+//
+// Nothing here touches a window, GL or the keyboard. A GameState takes one
+// PlayerAction per tick through handleInput and advances with update, so the
+// same code runs behind the window, headless, and many at a time in the
+// batch environment (batch_env.h). The systems are built once into the
+// space_invaders_core library (game_state.cpp).
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include "bunkers.h"
+#include "controller.h"
+#include "ecs.h"
+#include "formation.h"
+#include "job_system.h"
+#include "particles.h"
+#include "sound_bank.h"
+
+class AudioMixer;
+
+// Stateless random roll in [0, 100) for (seed, tick, stream, index). Results
+// don't depend on evaluation order, so rolls can be made from any thread.
+inline int rollPercent(uint64_t seed, uint64_t tick, uint32_t stream, uint32_t index) {
+    uint64_t z = seed ^ (tick * 0x9e3779b97f4a7c15ull) ^ ((uint64_t)stream << 32 | index);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z ^= z >> 31;
+    return (int)(z % 100);
+}
+
+// Independent rollPercent streams, one per kind of decision
+enum RandomStream : uint32_t {
+    kStreamEnemyFire,
+    kStreamEnemyType,
+    kStreamDrop,
+    kStreamDropKind,
+};
+
+// Large scenarios split entity loops into chunks of this size across the job
+// system. Below the threshold everything runs inline on the game thread.
+const size_t kParallelMinEntities = 8192;
+const size_t kParallelGrain = 2048;
+
+// Fixed simulation step. Fast-forward runs several of these per rendered frame.
+const float kTickDt = 1.0f / 60.0f;
+
+// Game components
+struct Position {
+    float x, y;
+};
+
+struct Velocity {
+    float dx, dy;  // Pixels per second
+};
+
+struct PowerUpKind {
+    int type;  // 0=shield, 1=rapidfire, 2=multishot, 3=slowmotion
+};
+
+// Entity archetypes
+using Bullets = Archetype<Position, Velocity>;
+using PowerUps = Archetype<Position, Velocity, PowerUpKind>;
+
+// Data named in system access declarations
+struct PlayerShip;
+struct PlayerBulletData;
+struct EnemyBulletData;
+struct PowerUpData;
+struct FormationData;
+struct ScoreData;      // score, combo, lives, game over
+struct PowerUpTimers;
+struct ParticleData;
+struct BunkerData;
+
+// Indices collected by one chunk of a parallel loop
+struct IndexList {
+    uint32_t* items;
+    size_t count;
+};
+
+struct GameState {
+    // Wave-scoped storage (formation rows, power-ups) comes from waveArena,
+    // which is emptied at every spawnWave. Per-tick temporaries come from
+    // tickArena, emptied at the start of every update. Both start in fixed
+    // buffers and only reach the heap if a wave or tick outgrows them.
+    alignas(std::max_align_t) unsigned char waveBuffer[16 * 1024];
+    alignas(std::max_align_t) unsigned char tickBuffer[64 * 1024];
+    std::pmr::monotonic_buffer_resource waveArena{waveBuffer, sizeof(waveBuffer)};
+    std::pmr::monotonic_buffer_resource tickArena{tickBuffer, sizeof(tickBuffer)};
+    
+    float playerX;
+    float playerY;
+    Bullets playerBullets;
+    Bullets enemyBullets;
+    Formation enemies{&waveArena};
+    PowerUps powerUps{&waveArena};
+    Bunkers bunkers;         // Rebuilt every wave
+    ParticlePool particles;
+    int score;
+    int lives;
+    int wave;
+    int comboCounter;
+    float comboMultiplier;
+    float enemyMoveTimer;
+    bool gameOver;
+    bool paused;
+    float gameSpeed;  // Difficulty multiplier
+    
+    // Power-up timers
+    float shieldActive;      // 0 = inactive
+    float rapidFireActive;   // 0 = inactive
+    float multiShotActive;   // 0 = inactive
+    float slowMotionActive;  // 0 = inactive
+    float shotCooldown;      // Seconds until the player may fire again
+    
+    uint64_t tick;           // Updates simulated so far
+    float lastDt;            // Length of the current tick, for swept collision
+    uint64_t rngSeed;        // Seed for rollPercent
+    float shootTimer;        // Seconds since the formation last fired
+    int marchStep;           // Formation steps this game, for the march's next note
+    JobSystem* jobs;         // Optional; null runs every system inline
+    AudioMixer* audio;       // Optional; null plays no sound
+    
+    // Every random decision derives from the seed, so a seed and the
+    // player's actions fully determine a game
+    explicit GameState(uint64_t seed, size_t particleCapacity = kMaxParticles);
+    
+    // Starts a new game in place, keeping the storage of the last one
+    void reset(uint64_t seed);
+    
+    // Builds the formation for the current wave
+    void spawnWave();
+    
+    // Seconds between formation steps
+    float formationStepInterval() const;
+    
+    // Advances the game by one tick of dt seconds
+    void update(float dt);
+    
+    // Runs fn(begin, end) over [0, n) in kParallelGrain chunks, on the job
+    // system when there is enough work. Chunking is the same either way, so
+    // results merged per chunk are identical with and without threads.
+    template <typename F>
+    void forChunks(size_t n, F&& fn) {
+        if (jobs && n >= kParallelMinEntities) {
+            jobs->parallelFor(n, kParallelGrain, fn);
+        } else {
+            for (size_t begin = 0; begin < n; begin += kParallelGrain) {
+                fn(begin, std::min(begin + kParallelGrain, n));
+            }
+        }
+    }
+    
+    // Allocates one empty index list per chunk of an n-entity loop from the
+    // tick arena, each with room for its whole chunk. Done up front on the
+    // game thread; workers then fill their own list without allocating.
+    IndexList* allocChunkLists(size_t n);
+    
+    // Systems, run in this order by update(). Each declares the data it reads
+    // and writes so independent ones can be scheduled together.
+    
+    using FormationSystem = SystemAccess<Reads<>, Writes<FormationData, ScoreData>>;
+    void formationSystem(float dt);
+    
+    using MovementSystem = SystemAccess<Reads<>, Writes<PlayerBulletData, EnemyBulletData, PowerUpData>>;
+    void movementSystem(float dt);
+    
+    using ParticleSystem = SystemAccess<Reads<>, Writes<ParticleData>>;
+    void particleSystem(float dt);
+    
+    using BunkerSystem = SystemAccess<Reads<FormationData>, Writes<PlayerBulletData, EnemyBulletData, BunkerData,
+                                                                   ParticleData>>;
+    void bunkerSystem();
+    
+    using EnemyHitSystem = SystemAccess<Reads<>, Writes<PlayerBulletData, FormationData, ScoreData, PowerUpData,
+                                                         ParticleData>>;
+    void enemyHitSystem();
+    
+    using PickupSystem = SystemAccess<Reads<PlayerShip>, Writes<PowerUpData, PowerUpTimers, ScoreData>>;
+    void pickupSystem();
+    
+    using PlayerHitSystem = SystemAccess<Reads<PlayerShip>, Writes<EnemyBulletData, PowerUpTimers, ScoreData>>;
+    void playerHitSystem();
+    
+    using TimerSystem = SystemAccess<Reads<>, Writes<PowerUpTimers>>;
+    void timerSystem(float dt);
+    
+    using FiringSystem = SystemAccess<Reads<FormationData, PowerUpTimers>, Writes<EnemyBulletData>>;
+    void firingSystem(float dt);
+    
+    using WaveSystem = SystemAccess<Reads<>, Writes<FormationData, PowerUpData>>;
+    void waveSystem();
+    
+    using CleanupSystem = SystemAccess<Reads<>, Writes<PlayerBulletData, EnemyBulletData, PowerUpData>>;
+    void cleanupSystem();
+    
+    // Applies velocity to entities [begin, end)
+    template <typename A>
+    static void integrate(A& archetype, size_t begin, size_t end, float dt) {
+        Position* pos = archetype.template get<Position>();
+        const Velocity* vel = archetype.template get<Velocity>();
+        for (size_t i = begin; i < end; i++) {
+            pos[i].x += vel[i].dx * dt;
+            pos[i].y += vel[i].dy * dt;
+        }
+    }
+    
+    // Stops bullets whose leading edge, `tip` px from their center, reached a
+    // bunker this tick, and blasts a crater where each one hit
+    void bulletsHitBunkers(Bullets& bullets, float tip, bool fromPlayer);
+    
+    // Kills entities [begin, end) past a horizontal line (above it if `above`, else below it)
+    template <typename A>
+    static void cull(A& archetype, size_t begin, size_t end, float limit, bool above) {
+        const Position* pos = archetype.template get<Position>();
+        uint8_t* alive = archetype.aliveFlags();
+        for (size_t i = begin; i < end; i++) {
+            bool out = above ? pos[i].y < limit : pos[i].y > limit;
+            alive[i] &= (uint8_t)!out;
+        }
+    }
+    
+    // Applies the player's action for this tick
+    void handleInput(const PlayerAction& action);
+    
+    // Plays a sound panned to world x, if there is a mixer
+    void playSound(SoundId id, float x, float volume = 1.0f);
+};
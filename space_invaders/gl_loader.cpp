@@ -0,0 +1,5 @@
+// The glad GL loader's function pointers and gladLoadGL, compiled once.
+// Everything else includes <glad/gl.h> for declarations only.
+
+#define GLAD_GL_IMPLEMENTATION
+#include <glad/gl.h>
@@ -0,0 +1,50 @@
+#pragma once
+
+// Shader program building shared by the renderers. Errors go to stderr
+// with the program's name, and a failed build returns 0, which callers
+// treat as "draw nothing".
+
+#include <glad/gl.h>
+#include <cstdio>
+
+inline GLuint compileShader(const char* name, GLenum stage, const char* source) {
+    GLuint shader = glCreateShader(stage);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+        fprintf(stderr, "%s shader failed to compile:\n%s\n", name, log);
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+inline GLuint buildProgram(const char* name, const char* vertexSource, const char* fragmentSource) {
+    GLuint vertex = compileShader(name, GL_VERTEX_SHADER, vertexSource);
+    GLuint fragment = compileShader(name, GL_FRAGMENT_SHADER, fragmentSource);
+    if (!vertex || !fragment) {
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+        return 0;
+    }
+    GLuint linked = glCreateProgram();
+    glAttachShader(linked, vertex);
+    glAttachShader(linked, fragment);
+    glLinkProgram(linked);
+    glDeleteShader(vertex);
+    glDeleteShader(fragment);
+    GLint ok = GL_FALSE;
+    glGetProgramiv(linked, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        glGetProgramInfoLog(linked, sizeof(log), nullptr, log);
+        fprintf(stderr, "%s shader failed to link:\n%s\n", name, log);
+        glDeleteProgram(linked);
+        return 0;
+    }
+    return linked;
+}
@@ -0,0 +1,56 @@
+// High score file management (see high_scores.h)
+
+#include "high_scores.h"
+
+#include <fstream>
+
+void loadHighScores(HighScoreTable& scores) {
+    std::ifstream file("highscores.txt");
+    
+    // Initialize with zeros
+    for (int i = 0; i < 10; i++) {
+        scores[i] = {0, 0};
+    }
+    
+    if (file.is_open()) {
+        for (int i = 0; i < 10; i++) {
+            if (file >> scores[i].score >> scores[i].wave) {
+                // Successfully read
+            } else {
+                break;
+            }
+        }
+        file.close();
+    }
+}
+
+void saveHighScores(const HighScoreTable& scores) {
+    std::ofstream file("highscores.txt");
+    if (file.is_open()) {
+        for (int i = 0; i < 10; i++) {
+            if (scores[i].score > 0) {
+                file << scores[i].score << " " << scores[i].wave << "\n";
+            }
+        }
+        file.close();
+    }
+}
+
+bool placeHighScore(HighScoreTable& scores, int newScore, int newWave) {
+    // Find the position to insert
+    for (int i = 0; i < 10; i++) {
+        if (newScore > scores[i].score) {
+            // Shift scores down
+            for (int j = 9; j > i; j--) {
+                scores[j] = scores[j - 1];
+            }
+            scores[i] = {newScore, newWave};
+            return true;
+        }
+    }
+    return false;
+}
+
+void insertHighScore(HighScoreTable& scores, int newScore, int newWave) {
+    if (placeHighScore(scores, newScore, newWave)) saveHighScores(scores);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+// The local top-ten table, kept in highscores.txt as "<score> <wave>" lines.
+
+#include <array>
+
+struct HighScore {
+    int score;
+    int wave;
+};
+
+using HighScoreTable = std::array<HighScore, 10>;
+
+// Missing entries (or a missing file) read as zero
+void loadHighScores(HighScoreTable& scores);
+void saveHighScores(const HighScoreTable& scores);
+
+// Inserts into the in-memory table only; returns false if the score doesn't place
+bool placeHighScore(HighScoreTable& scores, int newScore, int newWave);
+
+// Places the score and saves the table if it did
+void insertHighScore(HighScoreTable& scores, int newScore, int newWave);
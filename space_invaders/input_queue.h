@@ -0,0 +1,75 @@
+#pragma once
+
+// Timestamped keyboard event queue.
+//
+// The GLFW key callback pushes every press and release with the time it was
+// received; the simulation pops them at the start of each tick. Unlike
+// polling key state once per frame, a press and release that both happen
+// between two ticks are still seen as a tap. The queue is a fixed ring, so
+// input never allocates; it is only touched from the main thread.
+
+#include <cstddef>
+
+struct InputEvent {
+    int key;      // GLFW_KEY_*
+    bool pressed;
+    double time;  // glfwGetTime() when received
+};
+
+class InputQueue {
+public:
+    void push(int key, bool pressed, double time) {
+        if (tail - head == kCapacity) {
+            dropped++;
+            return;
+        }
+        events[tail % kCapacity] = {key, pressed, time};
+        tail++;
+    }
+
+    // Pops the oldest event, recording how long it waited until `now`
+    bool pop(InputEvent& event, double now) {
+        if (head == tail) return false;
+        event = events[head % kCapacity];
+        head++;
+        double latency = now - event.time;
+        latencySum += latency;
+        if (latency > latencyMax) latencyMax = latency;
+        if (consumed < (int)kCapacity) consumedTimes[consumed] = event.time;
+        consumed++;
+        return true;
+    }
+
+    // Queue-to-simulation latency of the events popped since the last call
+    struct Latency {
+        int events;
+        double totalSeconds;
+        double maxSeconds;
+    };
+
+    Latency takeLatency() {
+        Latency l = {consumed, latencySum, latencyMax};
+        consumed = 0;
+        latencySum = 0;
+        latencyMax = 0;
+        return l;
+    }
+
+    // Receive times of the events popped since the last takeLatency
+    int consumedCount() const { return consumed < (int)kCapacity ? consumed : (int)kCapacity; }
+    double consumedTime(int i) const { return consumedTimes[i]; }
+
+    size_t droppedEvents() const { return dropped; }
+
+private:
+    static const size_t kCapacity = 256;
+
+    InputEvent events[kCapacity];
+    size_t head = 0, tail = 0;
+    size_t dropped = 0;
+
+    int consumed = 0;
+    double latencySum = 0;
+    double latencyMax = 0;
+    double consumedTimes[kCapacity];
+};
@@ -0,0 +1,205 @@
+#pragma once
+
+// Work-stealing job scheduler.
+//
+// A fixed pool of workers, each owning a bounded deque of jobs. parallelFor
+// deals its chunks round-robin into every deque, the caller's included,
+// before waking the workers. Each thread pops its own chunks from the
+// bottom; one that runs dry steals from the top of another's deque. Jobs
+// are plain structs stored by value in the deques, so scheduling never
+// allocates. The calling thread takes part in its own parallelFor, so a
+// pool of N workers runs on N + 1 threads.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class JobSystem {
+public:
+    struct Stats {
+        uint64_t jobs = 0;
+        uint64_t steals = 0;
+        double idleSeconds = 0;  // Summed over workers
+    };
+
+    explicit JobSystem(int workerCount) : queues(workerCount + 1) {
+        for (int i = 0; i < workerCount; i++) {
+            workers.emplace_back(&JobSystem::workerLoop, this, i + 1);
+        }
+    }
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            quitting = true;
+        }
+        sleepWake.notify_all();
+        for (std::thread& t : workers) t.join();
+    }
+
+    int threadCount() const { return (int)queues.size(); }
+
+    // Runs fn(begin, end) over [0, count) in chunks of `grain` and returns
+    // when every chunk is done. Chunk boundaries depend only on count and
+    // grain, so callers can keep per-chunk results and merge them in order.
+    template <typename F>
+    void parallelFor(size_t count, size_t grain, F&& fn) {
+        if (count == 0) return;
+        if (grain == 0) grain = 1;
+        if (count <= grain || workers.empty()) {
+            fn((size_t)0, count);
+            return;
+        }
+
+        std::atomic<size_t> remaining((count + grain - 1) / grain);
+        Job job;
+        job.run = &invoke<typename std::remove_reference<F>::type>;
+        job.context = &fn;
+        job.remaining = &remaining;
+
+        // Deal chunk c to deque c % threads, pushing from the back so every
+        // owner pops its chunks in ascending order
+        size_t chunks = remaining.load();
+        for (size_t c = chunks; c-- > 0;) {
+            job.begin = c * grain;
+            job.end = job.begin + grain < count ? job.begin + grain : count;
+            while (!queues[c % queues.size()].push(job)) runOne(0);  // Deque full: help drain it
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            generation++;
+        }
+        sleepWake.notify_all();
+
+        while (remaining.load(std::memory_order_acquire) > 0) {
+            if (!runOne(0)) std::this_thread::yield();
+        }
+    }
+
+    // Returns the counters accumulated since the last call
+    Stats takeStats() {
+        Stats s;
+        s.jobs = jobCount.exchange(0);
+        s.steals = stealCount.exchange(0);
+        s.idleSeconds = idleNanos.exchange(0) * 1e-9;
+        return s;
+    }
+
+private:
+    struct Job {
+        void (*run)(void* context, size_t begin, size_t end);
+        void* context;
+        size_t begin, end;
+        std::atomic<size_t>* remaining;
+    };
+
+    // Bounded deque guarded by a spinlock; besides its owner, only the
+    // dealing parallelFor and thieves touch it
+    class Queue {
+    public:
+        bool push(const Job& job) {
+            Lock lock(busy);
+            if (bottom - top == kCapacity) return false;
+            slots[bottom % kCapacity] = job;
+            bottom++;
+            return true;
+        }
+
+        bool pop(Job& job) {
+            Lock lock(busy);
+            if (bottom == top) return false;
+            bottom--;
+            job = slots[bottom % kCapacity];
+            return true;
+        }
+
+        bool steal(Job& job) {
+            Lock lock(busy);
+            if (bottom == top) return false;
+            job = slots[top % kCapacity];
+            top++;
+            return true;
+        }
+
+    private:
+        static const size_t kCapacity = 1024;
+
+        struct Lock {
+            explicit Lock(std::atomic_flag& f) : flag(f) {
+                while (flag.test_and_set(std::memory_order_acquire)) std::this_thread::yield();
+            }
+            ~Lock() { flag.clear(std::memory_order_release); }
+            std::atomic_flag& flag;
+        };
+
+        std::atomic_flag busy = ATOMIC_FLAG_INIT;
+        Job slots[kCapacity];
+        size_t top = 0, bottom = 0;
+    };
+
+    template <typename F>
+    static void invoke(void* context, size_t begin, size_t end) {
+        (*static_cast<F*>(context))(begin, end);
+    }
+
+    // Runs one job from our own deque or, failing that, a stolen one
+    bool runOne(int self) {
+        Job job;
+        if (!queues[self].pop(job)) {
+            int n = (int)queues.size();
+            bool stolen = false;
+            for (int i = 1; i < n && !stolen; i++) {
+                stolen = queues[(self + i) % n].steal(job);
+            }
+            if (!stolen) return false;
+            stealCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        job.run(job.context, job.begin, job.end);
+        jobCount.fetch_add(1, std::memory_order_relaxed);
+        job.remaining->fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    void workerLoop(int self) {
+        using Clock = std::chrono::steady_clock;
+        uint64_t seen = 0;
+        for (;;) {
+            if (runOne(self)) continue;
+
+            // Spin briefly, then sleep until the next parallelFor
+            Clock::time_point idleStart = Clock::now();
+            bool found = false;
+            for (int spin = 0; spin < 256 && !found; spin++) {
+                std::this_thread::yield();
+                found = runOne(self);
+            }
+            if (!found) {
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                sleepWake.wait(lock, [&] { return quitting || generation != seen; });
+                if (quitting) return;
+                seen = generation;
+            }
+            idleNanos.fetch_add((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    Clock::now() - idleStart).count(),
+                                std::memory_order_relaxed);
+        }
+    }
+
+    std::vector<Queue> queues;  // queues[0] belongs to the calling thread
+    std::vector<std::thread> workers;
+
+    std::mutex sleepMutex;
+    std::condition_variable sleepWake;
+    bool quitting = false;
+    uint64_t generation = 0;  // Bumped by every parallelFor that queues work
+
+    std::atomic<uint64_t> jobCount{0};
+    std::atomic<uint64_t> stealCount{0};
+    std::atomic<uint64_t> idleNanos{0};
+};
@@ -0,0 +1,75 @@
+#pragma once
+
+// Turns the queued key events of a window into per-tick actions.
+//
+// Held keys follow the press/release events. A press is also latched until
+// the next tick, so a tap shorter than a tick still acts once. F (cycle
+// fast-forward) isn't part of a PlayerAction; its presses are counted for
+// the frame loop, which picks them up with takeSpeedPresses().
+
+#include <GLFW/glfw3.h>
+
+#include "controller.h"
+#include "input_queue.h"
+
+class KeyboardController : public Controller {
+public:
+    explicit KeyboardController(InputQueue& input) : input(input) {}
+
+    PlayerAction nextAction(const GameState&) override {
+        PlayerAction a;
+        InputEvent event;
+        while (input.pop(event, glfwGetTime())) {
+            switch (event.key) {
+                case GLFW_KEY_P:
+                    if (event.pressed) a.togglePause = !a.togglePause;
+                    break;
+                case GLFW_KEY_LEFT:
+                case GLFW_KEY_A:
+                    leftHeld = event.pressed;
+                    leftTapped |= event.pressed;
+                    break;
+                case GLFW_KEY_RIGHT:
+                case GLFW_KEY_D:
+                    rightHeld = event.pressed;
+                    rightTapped |= event.pressed;
+                    break;
+                case GLFW_KEY_SPACE:
+                    fireHeld = event.pressed;
+                    fireTapped |= event.pressed;
+                    break;
+                case GLFW_KEY_F:
+                    if (event.pressed) speedPresses++;
+                    break;
+            }
+        }
+
+        bool left = leftHeld || leftTapped;
+        bool right = rightHeld || rightTapped;
+        a.move = (right ? 1 : 0) - (left ? 1 : 0);
+        a.fire = fireHeld || fireTapped;
+        leftTapped = rightTapped = fireTapped = false;
+        return a;
+    }
+
+    // Empties the queue when another controller plays and no tick reads it,
+    // keeping only the F presses
+    void drain() {
+        InputEvent event;
+        while (input.pop(event, glfwGetTime())) {
+            if (event.key == GLFW_KEY_F && event.pressed) speedPresses++;
+        }
+    }
+
+    int takeSpeedPresses() {
+        int presses = speedPresses;
+        speedPresses = 0;
+        return presses;
+    }
+
+private:
+    InputQueue& input;
+    int speedPresses = 0;
+    bool leftHeld = false, rightHeld = false, fireHeld = false;
+    bool leftTapped = false, rightTapped = false, fireTapped = false;
+};
@@ -0,0 +1,169 @@
+#pragma once
+
+// Input-to-photon latency measurement, after GLFW's tests/inputlag.c.
+//
+// For every frame the probe records when simulation started, when rendering
+// was submitted and when glfwSwapBuffers returned, then places a GL fence
+// behind the swap. Fences are polled without blocking (the frame limiter
+// calls poll() while it waits), and the time a fence is seen signaled is
+// taken as the moment the GPU finished the frame. Each input event consumed
+// by the frame is measured from its GLFW callback to that moment.
+//
+// One CSV row is written per completed frame, and a histogram of the
+// per-event latency is printed when the probe stops. The display's own
+// scan-out delay comes on top and can't be observed from here.
+
+#include <glad/gl.h>
+#include <GLFW/glfw3.h>
+#include <cstdio>
+
+class LatencyProbe {
+public:
+    ~LatencyProbe() { stop(); }
+
+    bool start(const char* path) {
+        csv = fopen(path, "w");
+        if (!csv) {
+            fprintf(stderr, "Could not open latency log %s\n", path);
+            return false;
+        }
+        fprintf(csv, "frame,start_s,events,pace_wait_ms,event_to_sim_ms,sim_to_submit_ms,submit_to_swap_ms,"
+                     "swap_to_gpu_ms,event_to_gpu_ms\n");
+        return true;
+    }
+
+    bool isRunning() const { return csv != nullptr; }
+
+    // Time the frame pacer held the frame back before it started
+    void paced(double seconds) { paceWait = seconds; }
+
+    // Call right before the frame's first tick
+    void beginFrame(double now) {
+        if (!csv) return;
+        Frame& f = frames[(head + pending) % kMaxPending];
+        f.index = frameIndex++;
+        f.paceWait = paceWait;
+        f.simStart = now;
+        f.eventCount = 0;
+        paceWait = 0;
+    }
+
+    void eventConsumed(double receivedAt) {
+        if (!csv) return;
+        Frame& f = frames[(head + pending) % kMaxPending];
+        if (f.eventCount < kMaxEventsPerFrame) f.events[f.eventCount++] = receivedAt;
+    }
+
+    void submitted(double now) {
+        if (csv) frames[(head + pending) % kMaxPending].submit = now;
+    }
+
+    // Call right after glfwSwapBuffers
+    void swapped(double now) {
+        if (!csv) return;
+        if (pending == kMaxPending) complete(true);  // GPU far behind: wait for the oldest frame
+        Frame& f = frames[(head + pending) % kMaxPending];
+        f.swap = now;
+        f.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+        pending++;
+    }
+
+    // Retires every frame whose fence has signaled
+    void poll() {
+        while (pending > 0 && complete(false)) {
+        }
+    }
+
+    void stop() {
+        if (!csv) return;
+        while (pending > 0) complete(true);
+        fclose(csv);
+        csv = nullptr;
+        printHistogram();
+    }
+
+private:
+    static const int kMaxPending = 4;
+    static const int kMaxEventsPerFrame = 32;
+    static const int kBuckets = 100;  // 1 ms each; the last one also holds everything slower
+
+    struct Frame {
+        int index;
+        double paceWait;
+        double simStart, submit, swap;
+        double events[kMaxEventsPerFrame];
+        int eventCount;
+        GLsync fence;
+    };
+
+    bool complete(bool block) {
+        Frame& f = frames[head];
+        GLenum status = glClientWaitSync(f.fence, 0, block ? 1000000000ull : 0);
+        if (status == GL_TIMEOUT_EXPIRED && !block) return false;
+        double gpuDone = glfwGetTime();
+        glDeleteSync(f.fence);
+
+        double worstToSim = 0, worstToGpu = 0;
+        for (int i = 0; i < f.eventCount; i++) {
+            double toGpu = (gpuDone - f.events[i]) * 1000.0;
+            double toSim = (f.simStart - f.events[i]) * 1000.0;
+            if (toGpu > worstToGpu) worstToGpu = toGpu;
+            if (toSim > worstToSim) worstToSim = toSim;
+            int bucket = (int)toGpu;
+            histogram[bucket < 0 ? 0 : bucket >= kBuckets ? kBuckets - 1 : bucket]++;
+            sampleTotal += toGpu;
+            if (toGpu > sampleMax) sampleMax = toGpu;
+            samples++;
+        }
+        fprintf(csv, "%d,%.6f,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", f.index, f.simStart, f.eventCount,
+                f.paceWait * 1000.0, worstToSim, (f.submit - f.simStart) * 1000.0, (f.swap - f.submit) * 1000.0,
+                (gpuDone - f.swap) * 1000.0, worstToGpu);
+
+        head = (head + 1) % kMaxPending;
+        pending--;
+        return true;
+    }
+
+    double percentile(double p) const {
+        long target = (long)(p * samples);
+        long seen = 0;
+        for (int i = 0; i < kBuckets; i++) {
+            seen += histogram[i];
+            if (seen > target) return i + 1;
+        }
+        return kBuckets;
+    }
+
+    void printHistogram() const {
+        printf("\n===== INPUT-TO-PHOTON LATENCY =====\n");
+        if (samples == 0) {
+            printf("No input events recorded\n");
+            return;
+        }
+        printf("%ld events | mean %.2f ms | p50 < %.0f ms | p95 < %.0f ms | p99 < %.0f ms | max %.2f ms\n",
+               samples, sampleTotal / samples, percentile(0.5), percentile(0.95), percentile(0.99), sampleMax);
+        long largest = 0;
+        for (int i = 0; i < kBuckets; i++) {
+            if (histogram[i] > largest) largest = histogram[i];
+        }
+        for (int i = 0; i < kBuckets; i++) {
+            if (histogram[i] == 0) continue;
+            int bar = (int)(histogram[i] * 50 / largest);
+            printf("%3d%s ms %6ld ", i, i == kBuckets - 1 ? "+" : " ", histogram[i]);
+            for (int b = 0; b < (bar ? bar : 1); b++) putchar('#');
+            putchar('\n');
+        }
+    }
+
+    FILE* csv = nullptr;
+    Frame frames[kMaxPending];
+    int head = 0, pending = 0;
+    int frameIndex = 0;
+    double paceWait = 0;
+
+    long histogram[kBuckets] = {};
+    long samples = 0;
+    double sampleTotal = 0;
+    double sampleMax = 0;
+};
@@ -0,0 +1,245 @@
+#pragma once
+
+// Asynchronous client for the leaderboard daemon.
+//
+// submit() only queues the score; a background thread connects to the
+// daemon, delivers everything queued and refreshes a snapshot of the top
+// scores that the game reads with top(). If the daemon can't be reached,
+// submissions are appended to a local queue file (one short O_APPEND write
+// per entry, so concurrent games don't clobber each other) and delivered by
+// whichever game next reaches the daemon. Unix only.
+
+#ifndef _WIN32
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "leaderboard_protocol.h"
+
+class LeaderboardClient {
+public:
+    static constexpr int kTopCount = 10;
+
+    LeaderboardClient(const char* socketPath, const char* queuePath)
+        : socketPath(socketPath), queuePath(queuePath), worker(&LeaderboardClient::run, this) {}
+
+    // Makes a last delivery attempt; undelivered scores stay in the queue file
+    ~LeaderboardClient() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    LeaderboardClient(const LeaderboardClient&) = delete;
+    LeaderboardClient& operator=(const LeaderboardClient&) = delete;
+
+    // Scores of 0 aren't kept (the daemon would reject them)
+    void submit(int score, int wave) {
+        if (score <= 0 || wave <= 0) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            outbox.push_back({score, wave});
+        }
+        wake.notify_one();
+    }
+
+    // Copies the latest top scores, best first; -1 if the daemon hasn't answered yet
+    int top(LeaderboardEntry* entries, int max) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (boardSize < 0) return -1;
+        int count = boardSize < max ? boardSize : max;
+        for (int i = 0; i < count; i++) entries[i] = board[i];
+        return count;
+    }
+
+private:
+    static constexpr int kRetrySeconds = 5;
+    static constexpr int kTimeoutMs = 1000;
+
+    void run() {
+        bool refresh = true;  // Fetch the board once at startup
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            if (!refresh && outbox.empty() && !stopping) {
+                wake.wait_for(lock, std::chrono::seconds(kRetrySeconds));
+                refresh = !outbox.empty() || hasQueueFile();
+            }
+            bool last = stopping;
+            std::vector<LeaderboardEntry> sending;
+            sending.swap(outbox);
+            lock.unlock();
+
+            if (refresh || !sending.empty()) {
+                claimQueueFile(sending);
+                size_t delivered = 0;
+                int count = -1;
+                LeaderboardEntry latest[kTopCount];
+                exchange(sending, delivered, latest, count);
+                if (delivered < sending.size()) appendToQueueFile(sending, delivered);
+                if (count >= 0) {
+                    std::lock_guard<std::mutex> relock(mutex);
+                    for (int i = 0; i < count; i++) board[i] = latest[i];
+                    boardSize = count;
+                }
+            }
+            refresh = false;
+
+            lock.lock();
+            if (last && outbox.empty()) return;
+        }
+    }
+
+    // Sends the entries, then asks for the board. `delivered` counts the
+    // leading entries the daemon is done with: committed, or rejected as
+    // invalid, which no retry would fix. `count` stays -1 if the board
+    // wasn't received.
+    bool exchange(const std::vector<LeaderboardEntry>& entries, size_t& delivered, LeaderboardEntry* latest,
+                  int& count) const {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(address.sun_path)) return false;
+        strcpy(address.sun_path, socketPath.c_str());
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return false;
+        timeval timeout = {kTimeoutMs / 1000, (kTimeoutMs % 1000) * 1000};
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        if (connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+            close(fd);
+            return false;
+        }
+
+        std::string request;
+        char line[64];
+        for (const LeaderboardEntry& e : entries) {
+            snprintf(line, sizeof(line), "SUBMIT %d %d\n", e.score, e.wave);
+            request += line;
+        }
+        snprintf(line, sizeof(line), "TOP %d\n", kTopCount);
+        request += line;
+
+        bool ok = sendAll(fd, request);
+        LineReader reader(fd);
+        while (ok && delivered < entries.size()) {
+            ok = reader.next(line, sizeof(line)) && (strcmp(line, "OK") == 0 || strcmp(line, "ERR") == 0);
+            if (ok && line[0] == 'E') {
+                fprintf(stderr, "Leaderboard rejected score %d (wave %d)\n", entries[delivered].score,
+                        entries[delivered].wave);
+            }
+            if (ok) delivered++;
+        }
+        int announced = 0;
+        if (ok && reader.next(line, sizeof(line)) && sscanf(line, "TOP %d", &announced) == 1 &&
+            announced <= kTopCount) {
+            int received = 0;
+            while (received < announced && reader.next(line, sizeof(line)) &&
+                   sscanf(line, "%d %d", &latest[received].score, &latest[received].wave) == 2) {
+                received++;
+            }
+            if (received == announced) count = received;
+        }
+        close(fd);
+        return ok && count >= 0;
+    }
+
+    static bool sendAll(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            sent += (size_t)n;
+        }
+        return true;
+    }
+
+    class LineReader {
+    public:
+        explicit LineReader(int fd) : fd(fd) {}
+
+        bool next(char* line, size_t size) {
+            size_t length = 0;
+            for (;;) {
+                if (pos == end) {
+                    ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+                    if (n <= 0) return false;
+                    pos = 0;
+                    end = (size_t)n;
+                }
+                char c = buffer[pos++];
+                if (c == '\n') break;
+                if (length + 1 < size) line[length++] = c;
+            }
+            line[length] = '\0';
+            return true;
+        }
+
+    private:
+        int fd;
+        char buffer[512];
+        size_t pos = 0, end = 0;
+    };
+
+    bool hasQueueFile() const {
+        struct stat info;
+        return stat(queuePath.c_str(), &info) == 0;
+    }
+
+    // Takes over the local queue file (renaming it first, so only one game
+    // drains it) and adds its entries to the ones being sent
+    void claimQueueFile(std::vector<LeaderboardEntry>& entries) const {
+        std::string claimed = queuePath + "." + std::to_string((long)getpid());
+        if (rename(queuePath.c_str(), claimed.c_str()) != 0) return;
+        FILE* file = fopen(claimed.c_str(), "r");
+        if (file) {
+            LeaderboardEntry e;
+            while (fscanf(file, "%d %d", &e.score, &e.wave) == 2) entries.push_back(e);
+            fclose(file);
+        }
+        unlink(claimed.c_str());
+    }
+
+    void appendToQueueFile(const std::vector<LeaderboardEntry>& entries, size_t from) const {
+        int fd = open(queuePath.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+        if (fd < 0) {
+            fprintf(stderr, "Could not queue %zu score(s) in %s\n", entries.size() - from, queuePath.c_str());
+            return;
+        }
+        char line[64];
+        for (size_t i = from; i < entries.size(); i++) {
+            int length = snprintf(line, sizeof(line), "%d %d\n", entries[i].score, entries[i].wave);
+            if (write(fd, line, (size_t)length) != length) break;
+        }
+        close(fd);
+    }
+
+    const std::string socketPath;
+    const std::string queuePath;
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<LeaderboardEntry> outbox;
+    LeaderboardEntry board[kTopCount];
+    int boardSize = -1;
+    bool stopping = false;
+
+    std::thread worker;  // Last, so everything above exists before it starts
+};
+
+#endif
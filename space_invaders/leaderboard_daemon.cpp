@@ -0,0 +1,338 @@
+// Leaderboard daemon for sites running several game processes.
+//
+// Games connect over a Unix domain socket (see leaderboard_protocol.h).
+// Submissions are collected and committed in batches: every batch is one
+// append to the log followed by one fsync, and only then are the submitters
+// answered. The log is append-only and is replayed at startup; top-N queries
+// are served from the in-memory table. A single thread multiplexes every
+// client with poll(), so no locking is needed.
+
+#ifdef _WIN32
+#include <cstdio>
+
+int main()
+{
+    fprintf(stderr, "The leaderboard daemon needs Unix domain sockets and is not available on Windows.\n");
+    return 1;
+}
+#else
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "leaderboard_protocol.h"
+
+static const int kBatchIntervalMs = 50;   // Longest a submission waits for its commit
+static const size_t kBatchMaxEntries = 256;
+static const size_t kMaxLineLength = 64;
+
+static volatile sig_atomic_t quitRequested = 0;
+
+static void onSignal(int) {
+    quitRequested = 1;
+}
+
+static long long nowMs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+struct Client {
+    int fd;
+    std::string in, out;
+    std::string deferred;  // Requests held back so replies stay in order behind a commit
+    int awaitingCommit;    // Submissions not yet acknowledged
+    bool closing;          // Peer hung up; dropped once its submissions are committed
+};
+
+class Leaderboard {
+public:
+    bool open(const char* path) {
+        logFd = ::open(path, O_WRONLY | O_APPEND | O_CREAT, 0644);
+        if (logFd < 0) {
+            fprintf(stderr, "Could not open log %s: %s\n", path, strerror(errno));
+            return false;
+        }
+
+        // Replay; a torn last line from a crash simply fails to parse
+        FILE* log = fopen(path, "r");
+        int replayed = 0;
+        if (log) {
+            LeaderboardEntry e;
+            while (fscanf(log, "%d %d", &e.score, &e.wave) == 2) {
+                insert(e);
+                replayed++;
+            }
+            fclose(log);
+        }
+        printf("Replayed %d entries from %s\n", replayed, path);
+        return true;
+    }
+
+    void stage(const LeaderboardEntry& e) {
+        pending.push_back(e);
+        insert(e);
+    }
+
+    bool hasPending() const { return !pending.empty(); }
+    size_t pendingCount() const { return pending.size(); }
+
+    // Appends the staged entries with one write and one fsync
+    bool commit() {
+        if (pending.empty()) return true;
+        std::string batch;
+        char line[kMaxLineLength];
+        for (const LeaderboardEntry& e : pending) {
+            snprintf(line, sizeof(line), "%d %d\n", e.score, e.wave);
+            batch += line;
+        }
+        pending.clear();
+
+        const char* p = batch.data();
+        size_t left = batch.size();
+        while (left > 0) {
+            ssize_t n = write(logFd, p, left);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                fprintf(stderr, "Log write failed: %s\n", strerror(errno));
+                return false;
+            }
+            p += n;
+            left -= (size_t)n;
+        }
+        if (fsync(logFd) != 0) {
+            fprintf(stderr, "Log fsync failed: %s\n", strerror(errno));
+            return false;
+        }
+        return true;
+    }
+
+    const std::vector<LeaderboardEntry>& best() const { return top; }
+
+private:
+    // Keeps the best kLeaderboardMaxTop entries, ties in arrival order
+    void insert(const LeaderboardEntry& e) {
+        auto at = std::upper_bound(top.begin(), top.end(), e, [](const LeaderboardEntry& a, const LeaderboardEntry& b) {
+            return a.score > b.score;
+        });
+        if (at - top.begin() >= kLeaderboardMaxTop) return;
+        top.insert(at, e);
+        if ((int)top.size() > kLeaderboardMaxTop) top.pop_back();
+    }
+
+    int logFd = -1;
+    std::vector<LeaderboardEntry> pending;
+    std::vector<LeaderboardEntry> top;
+};
+
+// A submission the daemon accepts; anything else gets ERR
+static bool parseSubmit(const std::string& line, LeaderboardEntry& e) {
+    return sscanf(line.c_str(), "SUBMIT %d %d", &e.score, &e.wave) == 2 && e.score > 0 && e.wave > 0;
+}
+
+static void handleLine(Client& client, const std::string& line, Leaderboard& board) {
+    LeaderboardEntry e;
+    int n;
+    if (parseSubmit(line, e)) {
+        board.stage(e);
+        client.awaitingCommit++;
+    } else if (sscanf(line.c_str(), "TOP %d", &n) == 1 && n > 0) {
+        const std::vector<LeaderboardEntry>& best = board.best();
+        int count = std::min(n, (int)best.size());
+        char reply[kMaxLineLength];
+        snprintf(reply, sizeof(reply), "TOP %d\n", count);
+        client.out += reply;
+        for (int i = 0; i < count; i++) {
+            snprintf(reply, sizeof(reply), "%d %d\n", best[i].score, best[i].wave);
+            client.out += reply;
+        }
+    } else {
+        client.out += "ERR\n";
+    }
+}
+
+// Handles the complete lines in text. Submissions are acknowledged only by
+// the commit, so once one is outstanding, any other request (a rejected
+// SUBMIT included) and everything after it waits for that commit to keep
+// replies in request order.
+static void handleLines(Client& client, const std::string& text, Leaderboard& board) {
+    size_t start = 0, end;
+    while ((end = text.find('\n', start)) != std::string::npos) {
+        std::string line = text.substr(start, end - start);
+        start = end + 1;
+        LeaderboardEntry e;
+        if (!client.deferred.empty() || (client.awaitingCommit > 0 && !parseSubmit(line, e))) {
+            client.deferred += line;
+            client.deferred += '\n';
+        } else {
+            handleLine(client, line, board);
+        }
+    }
+}
+
+// Reads what the client sent and handles complete lines; false once it is gone
+static bool readClient(Client& client, Leaderboard& board) {
+    char buffer[512];
+    for (;;) {
+        ssize_t n = recv(client.fd, buffer, sizeof(buffer), 0);
+        if (n > 0) {
+            client.in.append(buffer, (size_t)n);
+            continue;
+        }
+        if (n == 0) return false;
+        if (errno == EINTR) continue;
+        if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+        return false;
+    }
+
+    size_t complete = client.in.rfind('\n') + 1;  // 0 if there is no newline yet
+    handleLines(client, client.in.substr(0, complete), board);
+    client.in.erase(0, complete);
+    return client.in.size() <= kMaxLineLength;  // A client that never sends a newline is dropped
+}
+
+static bool flushClient(Client& client) {
+    while (!client.out.empty()) {
+        ssize_t n = send(client.fd, client.out.data(), client.out.size(), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        client.out.erase(0, (size_t)n);
+    }
+    return true;
+}
+
+static const char* kUsage =
+    "Usage: %s [options]\n"
+    "  --socket <path>  Socket to listen on (default: " LEADERBOARD_DEFAULT_SOCKET ")\n"
+    "  --log <path>     Append-only score log (default: leaderboard.log)\n";
+
+int main(int argc, char* argv[])
+{
+    const char* socketPath = LEADERBOARD_DEFAULT_SOCKET;
+    const char* logPath = "leaderboard.log";
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (strcmp(argv[i], "--log") == 0 && i + 1 < argc) {
+            logPath = argv[++i];
+        } else {
+            fprintf(stderr, kUsage, argv[0]);
+            return -1;
+        }
+    }
+
+    Leaderboard board;
+    if (!board.open(logPath)) return -1;
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        fprintf(stderr, "Socket path too long: %s\n", socketPath);
+        return -1;
+    }
+    strcpy(address.sun_path, socketPath);
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socketPath);  // Left over from a previous run
+    if (listener < 0 || bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 64) != 0) {
+        fprintf(stderr, "Could not listen on %s: %s\n", socketPath, strerror(errno));
+        return -1;
+    }
+    fcntl(listener, F_SETFL, O_NONBLOCK);
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+    printf("Leaderboard listening on %s\n", socketPath);
+
+    std::vector<Client> clients;
+    std::vector<pollfd> fds;
+    long long batchStart = 0;
+    while (!quitRequested) {
+        fds.clear();
+        fds.push_back({listener, POLLIN, 0});
+        for (const Client& c : clients) {
+            // A hung-up client only waits for its commit; poll ignores negative fds
+            if (c.closing) fds.push_back({-1, 0, 0});
+            else fds.push_back({c.fd, (short)(POLLIN | (c.out.empty() ? 0 : POLLOUT)), 0});
+        }
+
+        int timeout = -1;
+        if (board.hasPending()) {
+            long long wait = batchStart + kBatchIntervalMs - nowMs();
+            timeout = wait > 0 ? (int)wait : 0;
+        }
+        if (poll(fds.data(), fds.size(), timeout) < 0 && errno != EINTR) {
+            fprintf(stderr, "poll failed: %s\n", strerror(errno));
+            break;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int fd;
+            while ((fd = accept(listener, nullptr, nullptr)) >= 0) {
+                fcntl(fd, F_SETFL, O_NONBLOCK);
+                clients.push_back({fd, std::string(), std::string(), std::string(), 0, false});
+            }
+        }
+
+        bool hadPending = board.hasPending();
+        for (size_t i = 1; i < fds.size(); i++) {
+            Client& c = clients[i - 1];
+            if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) {
+                if (!readClient(c, board)) c.closing = true;
+            }
+        }
+        if (!hadPending && board.hasPending()) batchStart = nowMs();
+
+        // Group commit, then acknowledge everything it covered
+        if (board.hasPending() && (nowMs() - batchStart >= kBatchIntervalMs || board.pendingCount() >= kBatchMaxEntries)) {
+            bool committed = board.commit();
+            for (Client& c : clients) {
+                while (c.awaitingCommit > 0) {
+                    c.out += committed ? "OK\n" : "FAIL\n";
+                    c.awaitingCommit--;
+                }
+                std::string held;
+                held.swap(c.deferred);
+                handleLines(c, held, board);
+            }
+            if (board.hasPending()) batchStart = nowMs();
+        }
+
+        for (size_t i = 0; i < clients.size();) {
+            Client& c = clients[i];
+            bool alive = flushClient(c);
+            if (!alive || (c.closing && c.awaitingCommit == 0)) {
+                close(c.fd);
+                clients[i] = clients.back();
+                clients.pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+
+    board.commit();
+    for (Client& c : clients) close(c.fd);
+    close(listener);
+    unlink(socketPath);
+    printf("Leaderboard stopped\n");
+    return 0;
+}
+
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+
+// Wire protocol between the game and the leaderboard daemon.
+//
+// Plain text lines over a Unix domain stream socket:
+//   SUBMIT <score> <wave>   ->  OK            (sent once the entry is in the log)
+//                               FAIL          (the log write failed; worth retrying)
+//   TOP <n>                 ->  TOP <k>, then k lines of "<score> <wave>", best first
+// Anything else, including a SUBMIT whose score or wave isn't a positive
+// integer, is answered with ERR. Replies come in request order.
+
+#define LEADERBOARD_DEFAULT_SOCKET "/tmp/space_invaders_leaderboard.sock"
+
+struct LeaderboardEntry {
+    int score;
+    int wave;
+};
+
+constexpr int kLeaderboardMaxTop = 100;  // Largest TOP the daemon answers
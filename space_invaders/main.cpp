@@ -1,24 +1,41 @@
 #include <cstdio>
-#include <GL/glew.h>
+#include <glad/gl.h>
 #include <GLFW/glfw3.h>
 #include <vector>
 #include <cmath>
 #include <algorithm>
 #include <cstdlib>
 #include <ctime>
-#include <fstream>
 #include <string>
 #include <array>
+#include <cstring>
+#include <thread>
+#include <memory>
+#include <memory_resource>
+#include <chrono>
+
+#include "frame_capture.h"
+#include "game_state.h"
+#include "high_scores.h"
+#include "bot_controller.h"
+#include "job_system.h"
+#include "profiler.h"
+#include "alloc_tracker.h"
+#include "audio_mixer.h"
+#include "bunker_renderer.h"
+#include "particle_renderer.h"
+#include "sprite_renderer.h"
+#include "starfield_renderer.h"
+#include "input_queue.h"
+#include "keyboard_controller.h"
+#include "latency_probe.h"
+#include "frame_pacer.h"
+#include "leaderboard_client.h"
+#include "telemetry.h"
 
 #define GL_ERROR_CASE(glerror)\
     case glerror: snprintf(error, sizeof(error), "%s", #glerror)
 
-// Game structures (forward declarations)
-struct HighScore {
-    int score;
-    int wave;
-};
-
 inline void gl_debug(const char *file, int line) {
     GLenum err;
     while((err = glGetError()) != GL_NO_ERROR){
@@ -37,544 +54,314 @@ inline void gl_debug(const char *file, int line) {
     }
 }
 
-// High score file management
-void loadHighScores(std::array<HighScore, 10>& scores) {
-    std::ifstream file("highscores.txt");
-    
-    // Initialize with zeros
-    for (int i = 0; i < 10; i++) {
-        scores[i] = {0, 0};
-    }
-    
-    if (file.is_open()) {
-        for (int i = 0; i < 10; i++) {
-            if (file >> scores[i].score >> scores[i].wave) {
-                // Successfully read
-            } else {
-                break;
-            }
-        }
-        file.close();
-    }
+// Enemies switch animation frames on every formation step, which moves
+// the formation one step sideways or one drop down
+static int enemyAnimationFrame(const Formation& enemies) {
+    return ((int)std::lround(enemies.originX / enemies.moveStep) + (int)std::lround(enemies.originY / enemies.dropStep)) & 1;
 }
 
-void saveHighScores(const std::array<HighScore, 10>& scores) {
-    std::ofstream file("highscores.txt");
-    if (file.is_open()) {
-        for (int i = 0; i < 10; i++) {
-            if (scores[i].score > 0) {
-                file << scores[i].score << " " << scores[i].wave << "\n";
-            }
-        }
-        file.close();
-    }
-}
-
-void insertHighScore(std::array<HighScore, 10>& scores, int newScore, int newWave) {
-    // Find the position to insert
-    for (int i = 0; i < 10; i++) {
-        if (newScore > scores[i].score) {
-            // Shift scores down
-            for (int j = 9; j > i; j--) {
-                scores[j] = scores[j - 1];
-            }
-            scores[i] = {newScore, newWave};
-            saveHighScores(scores);
-            return;
+// Queues the live enemies of one type, with its color and armor baked in
+template <int Type>
+static void drawEnemies(const Formation& enemies, SpriteRenderer& sprites, int frame) {
+    constexpr const EnemyArchetype& archetype = kEnemyArchetypes[Type];
+    const SpriteId sprite = (SpriteId)(kEnemySprites[Type] + frame);
+    const uint32_t color = spriteColor(archetype.r, archetype.g, archetype.b);
+    const uint32_t armor = spriteColor(1.0f, 1.0f, 1.0f);
+    
+    for (int row = 0; row < (int)enemies.rows.size(); row++) {
+        float ey = enemies.cellY(row);
+        uint64_t mask = enemies.rows[row].type[Type];
+        while (mask) {
+            float ex = enemies.cellX(lowestBit(mask));
+            mask &= mask - 1;
+            sprites.add(sprite, ex, ey, color);
+            if constexpr (archetype.armored) sprites.add(kSpriteFrame, ex, ey, 36, 36, armor);
         }
     }
 }
 
-// Game structures
-struct Bullet {
-    float x, y;
-    bool active;
-};
-
-struct PowerUp {
-    float x, y;
-    int type;  // 0=shield, 1=rapidfire, 2=multishot, 3=slowmotion
-    bool active;
-};
-
-struct Enemy {
-    float x, y;
-    int type;     // 0=weak, 1=normal, 2=tank
-    int health;   // Number of hits to destroy
-    bool active;
-};
-
-struct GameState {
-    float playerX;
-    float playerY;
-    std::vector<Bullet> playerBullets;
-    std::vector<Bullet> enemyBullets;
-    std::vector<Enemy> enemies;
-    std::vector<PowerUp> powerUps;
-    int score;
-    int lives;
-    int wave;
-    int comboCounter;
-    float comboMultiplier;
-    float enemyMoveTimer;
-    float enemyDirection;
-    bool gameOver;
-    bool paused;
-    float gameSpeed;  // Difficulty multiplier
-    std::array<HighScore, 10> highScores;
-    int nextHighScoreIndex;
+// Draws a frame of the game: the stars, the bunkers, every sprite in one batch, then the particles
+static void render(const GameState& game, StarfieldRenderer& stars, BunkerRenderer& bunkers, SpriteRenderer& sprites,
+                   ParticleRenderer& particles) {
+    glClear(GL_COLOR_BUFFER_BIT);
     
-    // Power-up timers
-    float shieldActive;      // 0 = inactive
-    float rapidFireActive;   // 0 = inactive
-    float multiShotActive;   // 0 = inactive
-    float slowMotionActive;  // 0 = inactive
+    // Stars run on game time, wrapped to their period, so they stop when the game pauses
+    const uint64_t starPeriodTicks = (uint64_t)(kStarfieldPeriod / kTickDt + 0.5);
+    stars.draw((float)(game.tick % starPeriodTicks) * kTickDt);
+    bunkers.draw(game.bunkers, 0.0f, 1.0f, 0.0f);
     
-    GameState() : playerX(320), playerY(420), score(0), lives(3), wave(1), comboCounter(0), comboMultiplier(1.0f),
-                  enemyMoveTimer(0), enemyDirection(1.0f), gameOver(false), paused(false), gameSpeed(1.0f), nextHighScoreIndex(0),
-                  shieldActive(0), rapidFireActive(0), multiShotActive(0), slowMotionActive(0) {
-        loadHighScores(highScores);
-        spawnWave();
+    // Player ship, in a bubble while the shield is up
+    sprites.add(kSpriteShip, game.playerX, game.playerY, spriteColor(0.0f, 1.0f, 0.0f));
+    if (game.shieldActive > 0) {
+        sprites.add(kSpriteShield, game.playerX, game.playerY, spriteColor(0.3f, 0.8f, 1.0f));
     }
     
-    void spawnWave() {
-        enemies.clear();
-        powerUps.clear();
-        
-        // Increase difficulty with each wave
-        int rows = 2 + (wave / 2);
-        int cols = 6;
-        
-        for (int row = 0; row < rows; row++) {
-            for (int col = 0; col < cols; col++) {
-                Enemy e;
-                e.x = 50 + col * 90;
-                e.y = 30 + row * 50;
-                e.active = true;
-                
-                // Determine enemy type based on wave
-                int rand_type = rand() % 100;
-                if (wave < 3) {
-                    // Early waves: mostly normal enemies
-                    e.type = (rand_type < 70) ? 1 : 0;  // 70% normal, 30% weak
-                } else if (wave < 7) {
-                    // Mid waves: mix of all types
-                    if (rand_type < 50) e.type = 1;      // 50% normal
-                    else if (rand_type < 80) e.type = 0; // 30% weak
-                    else e.type = 2;                      // 20% tank
-                } else {
-                    // Later waves: more tanks
-                    if (rand_type < 40) e.type = 1;      // 40% normal
-                    else if (rand_type < 60) e.type = 0; // 20% weak
-                    else e.type = 2;                      // 40% tank
-                }
-                
-                // Set health based on type
-                if (e.type == 0) e.health = 1;      // Weak: 1 hit
-                else if (e.type == 1) e.health = 1; // Normal: 1 hit
-                else e.health = 3;                  // Tank: 3 hits
-                
-                enemies.push_back(e);
-            }
-        }
-    }
+    // Enemies, one pass per type
+    int frame = enemyAnimationFrame(game.enemies);
+    forEachEnemyType([&](auto type) { drawEnemies<decltype(type)::value>(game.enemies, sprites, frame); });
     
-    void update(float dt) {
-        if (gameOver || paused) return;
-        
-        // Move enemies with difficulty scaling
-        enemyMoveTimer += dt;
-        float moveSpeed = 1.0f - (wave * 0.1f);  // Gets faster with each wave
-        moveSpeed = moveSpeed < 0.3f ? 0.3f : moveSpeed;
-        
-        if (enemyMoveTimer > moveSpeed) {
-            enemyMoveTimer = 0;
-            bool hitEdge = false;
-            
-            for (auto& e : enemies) {
-                if (e.active) {
-                    e.x += 15 * enemyDirection;
-                    if (e.x < 20 || e.x > 600) {
-                        hitEdge = true;
-                    }
-                }
+    // Power-up icons in their colors, inside a brighter glow
+    const Position* powerUpPos = game.powerUps.get<Position>();
+    const PowerUpKind* powerUpKind = game.powerUps.get<PowerUpKind>();
+    for (size_t i = 0; i < game.powerUps.size(); i++) {
+        if (game.powerUps.isAlive(i)) {
+            const Position& p = powerUpPos[i];
+            float r, g, b;
+            SpriteId icon;
+            switch (powerUpKind[i].type) {
+                case 0: r = 0.3f; g = 0.8f; b = 1.0f; icon = kSpritePowerUpShield; break;      // Shield: Cyan
+                case 1: r = 1.0f; g = 0.8f; b = 0.0f; icon = kSpritePowerUpRapidFire; break;   // Rapid Fire: Orange
+                case 2: r = 1.0f; g = 0.0f; b = 1.0f; icon = kSpritePowerUpMultiShot; break;   // Multi-shot: Magenta
+                case 3: r = 0.5f; g = 0.0f; b = 1.0f; icon = kSpritePowerUpSlowMotion; break;  // Slow Motion: Purple
+                default: r = 1.0f; g = 1.0f; b = 1.0f; icon = kSpriteFrame;
             }
             
-            if (hitEdge) {
-                enemyDirection *= -1.0f;
-                for (auto& e : enemies) {
-                    if (e.active) {
-                        e.y += 20;
-                        if (e.y > 400) {
-                            gameOver = true;
-                        }
-                    }
-                }
-            }
-        }
-        
-        // Update bullets
-        for (auto& b : playerBullets) {
-            if (b.active) {
-                b.y -= 5.0f;  // Slightly faster bullets
-                if (b.y < 0) b.active = false;
-                
-                // Check collision with enemies
-                for (auto& e : enemies) {
-                    if (e.active && 
-                        b.x > e.x - 15 && b.x < e.x + 15 &&
-                        b.y > e.y - 15 && b.y < e.y + 15) {
-                        b.active = false;
-                        
-                        // Reduce health based on enemy type
-                        int pointsValue = 0;
-                        if (e.type == 0) pointsValue = 10;      // Weak enemy: 10 points
-                        else if (e.type == 1) pointsValue = 20; // Normal enemy: 20 points
-                        else pointsValue = 50;                  // Tank enemy: 50 points
-                        
-                        e.health--;
-                        
-                        // Check if enemy defeated
-                        if (e.health <= 0) {
-                            e.active = false;
-                            comboCounter++;
-                            
-                            // Update combo multiplier
-                            if (comboCounter >= 20) comboMultiplier = 2.0f;
-                            else if (comboCounter >= 10) comboMultiplier = 1.5f;
-                            else if (comboCounter >= 5) comboMultiplier = 1.25f;
-                            else comboMultiplier = 1.0f;
-                            
-                            // Calculate score with combo multiplier
-                            score += (int)(pointsValue * wave * comboMultiplier);
-                            
-                            // Spawn power-up (20% chance)
-                            if (rand() % 100 < 20) {
-                                PowerUp p;
-                                p.x = e.x;
-                                p.y = e.y;
-                                p.type = rand() % 4;  // Random power-up type
-                                p.active = true;
-                                powerUps.push_back(p);
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        
-        // Update power-ups
-        for (auto& p : powerUps) {
-            if (p.active) {
-                // Power-ups float down slowly
-                p.y += 1.0f;
-                if (p.y > 480) p.active = false;
-                
-                // Check collision with player
-                if (p.x > playerX - 20 && p.x < playerX + 20 &&
-                    p.y > playerY - 25 && p.y < playerY + 20) {
-                    p.active = false;
-                    
-                    // Apply power-up based on type
-                    switch (p.type) {
-                        case 0: shieldActive = 1.0f; break;        // Shield: 1 unit
-                        case 1: rapidFireActive = 8.0f; break;     // Rapid fire: 8 seconds
-                        case 2: multiShotActive = 10.0f; break;    // Multi-shot: 10 seconds
-                        case 3: slowMotionActive = 5.0f; break;    // Slow motion: 5 seconds
-                    }
-                    
-                    score += 100;  // Bonus for collecting power-up
-                }
-            }
-        }
-        
-        for (auto& b : enemyBullets) {
-            if (b.active) {
-                b.y += 2.5f;
-                if (b.y > 480) b.active = false;
-                
-                // Check collision with player
-                if (b.x > playerX - 20 && b.x < playerX + 20 &&
-                    b.y > playerY - 20 && b.y < playerY + 20) {
-                    b.active = false;
-                    
-                    // Check if shield is active
-                    if (shieldActive > 0) {
-                        shieldActive = 0;  // Shield blocks one hit
-                    } else {
-                        comboCounter = 0;  // Reset combo on hit
-                        comboMultiplier = 1.0f;
-                        lives--;
-                        if (lives <= 0) gameOver = true;
-                    }
-                }
-            }
+            sprites.add(icon, p.x, p.y, spriteColor(r, g, b));
+            sprites.add(kSpriteFrame, p.x, p.y, spriteColor(r * 1.5f, g * 1.5f, b * 1.5f));
         }
-        
-        // Update power-up timers
-        if (shieldActive > 0) shieldActive -= dt;
-        if (rapidFireActive > 0) rapidFireActive -= dt;
-        if (multiShotActive > 0) multiShotActive -= dt;
-        if (slowMotionActive > 0) slowMotionActive -= dt;
-        
-        // Enemy shooting - more aggressive at higher waves
-        static float shootTimer = 0;
-        shootTimer += dt;
-        
-        // Adjust shoot interval based on slow motion
-        float shootInterval = (0.5f / wave) / (slowMotionActive > 0 ? 2.0f : 1.0f);
-        shootInterval = shootInterval < 0.1f ? 0.1f : shootInterval;
-        
-        if (shootTimer > shootInterval) {
-            shootTimer = 0;
-            for (auto& e : enemies) {
-                if (e.active) {
-                    // Tank enemies shoot more frequently
-                    int shootChance = 5 + wave * 2;
-                    if (e.type == 2) shootChance *= 2;  // Tank: 2x more often
-                    else if (e.type == 0) shootChance /= 2;  // Weak: half as often
-                    
-                    if (rand() % 100 < shootChance) {
-                        Bullet b;
-                        b.x = e.x;
-                        b.y = e.y + 20;
-                        b.active = true;
-                        enemyBullets.push_back(b);
-                    }
-                }
-            }
-        }
-        
-        // Check if all enemies defeated
-        bool allDefeated = true;
-        for (auto& e : enemies) {
-            if (e.active) {
-                allDefeated = false;
-                break;
-            }
-        }
-        
-        if (allDefeated) {
-            // Next wave!
-            wave++;
-            spawnWave();
-        }
-        
-        // Clean up inactive bullets and power-ups
-        playerBullets.erase(
-            std::remove_if(playerBullets.begin(), playerBullets.end(),
-                          [](const Bullet& b) { return !b.active; }),
-            playerBullets.end()
-        );
-        enemyBullets.erase(
-            std::remove_if(enemyBullets.begin(), enemyBullets.end(),
-                          [](const Bullet& b) { return !b.active; }),
-            enemyBullets.end()
-        );
-        powerUps.erase(
-            std::remove_if(powerUps.begin(), powerUps.end(),
-                          [](const PowerUp& p) { return !p.active; }),
-            powerUps.end()
-        );
     }
     
-    void handleInput(GLFWwindow* window) {
-        // Toggle pause
-        static bool pKeyPressed = false;
-        bool pKeyDown = glfwGetKey(window, GLFW_KEY_P) == GLFW_PRESS;
-        if (pKeyDown && !pKeyPressed) {
-            paused = !paused;
-        }
-        pKeyPressed = pKeyDown;
-        
-        if (paused) return;  // Don't process other input while paused
-        
-        if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS || 
-            glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS) {
-            playerX -= 7.0f;  // Slightly faster movement
-            if (playerX < 20) playerX = 20;
-        }
-        if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS || 
-            glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS) {
-            playerX += 7.0f;
-            if (playerX > 620) playerX = 620;
-        }
-        if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS) {
-            // Shoot - with power-up support
-            static double lastShootTime = 0;
-            double currentTime = glfwGetTime();
-            
-            // Adjust cooldown based on rapid fire power-up
-            float cooldown = 0.2f;
-            if (rapidFireActive > 0) cooldown = 0.1f;  // 2x fire rate
-            
-            if (currentTime - lastShootTime > cooldown) {
-                lastShootTime = currentTime;
-                
-                // Multi-shot mode: 3 bullets
-                if (multiShotActive > 0) {
-                    Bullet b1, b2, b3;
-                    
-                    // Center bullet
-                    b1.x = playerX;
-                    b1.y = playerY - 20;
-                    b1.active = true;
-                    playerBullets.push_back(b1);
-                    
-                    // Left bullet
-                    b2.x = playerX - 15;
-                    b2.y = playerY - 20;
-                    b2.active = true;
-                    playerBullets.push_back(b2);
-                    
-                    // Right bullet
-                    b3.x = playerX + 15;
-                    b3.y = playerY - 20;
-                    b3.active = true;
-                    playerBullets.push_back(b3);
-                } else {
-                    // Normal single shot
-                    Bullet b;
-                    b.x = playerX;
-                    b.y = playerY - 20;
-                    b.active = true;
-                    playerBullets.push_back(b);
-                }
-            }
+    // Player bullets (yellow)
+    const uint32_t playerBulletColor = spriteColor(1.0f, 1.0f, 0.0f);
+    const Position* playerBulletPos = game.playerBullets.get<Position>();
+    for (size_t i = 0; i < game.playerBullets.size(); i++) {
+        if (game.playerBullets.isAlive(i)) {
+            sprites.add(kSpritePlayerBullet, playerBulletPos[i].x, playerBulletPos[i].y, playerBulletColor);
         }
     }
     
-    void render() {
-        glClear(GL_COLOR_BUFFER_BIT);
-        glLoadIdentity();
-        
-        // Draw player (green triangle - spaceship shape)
-        // If shield is active, draw an outline
-        if (shieldActive > 0) {
-            glColor3f(0.3f, 0.8f, 1.0f);  // Cyan outline
-            glBegin(GL_LINE_LOOP);
-            glVertex2f(playerX, playerY - 30);
-            glVertex2f(playerX - 25, playerY + 25);
-            glVertex2f(playerX + 25, playerY + 25);
-            glEnd();
+    // Enemy bullets (orange), wiggling every few ticks
+    const uint32_t enemyBulletColor = spriteColor(1.0f, 0.5f, 0.0f);
+    const SpriteId enemyBullet = (game.tick / 4) % 2 ? kSpriteEnemyBullet1 : kSpriteEnemyBullet0;
+    const Position* enemyBulletPos = game.enemyBullets.get<Position>();
+    for (size_t i = 0; i < game.enemyBullets.size(); i++) {
+        if (game.enemyBullets.isAlive(i)) {
+            sprites.add(enemyBullet, enemyBulletPos[i].x, enemyBulletPos[i].y, enemyBulletColor);
         }
-        
-        glColor3f(0.0f, 1.0f, 0.0f);
-        glBegin(GL_TRIANGLES);
-        glVertex2f(playerX, playerY - 25);      // Top point
-        glVertex2f(playerX - 20, playerY + 20); // Bottom left
-        glVertex2f(playerX + 20, playerY + 20); // Bottom right
-        glEnd();
-        
-        // Draw enemies with different colors based on type
-        for (const auto& e : enemies) {
-            if (e.active) {
-                // Color based on enemy type
-                if (e.type == 0) {
-                    // Weak: Yellow
-                    glColor3f(1.0f, 1.0f, 0.0f);
-                } else if (e.type == 1) {
-                    // Normal: Red
-                    glColor3f(1.0f, 0.0f, 0.0f);
-                } else {
-                    // Tank: Dark Red/Maroon
-                    glColor3f(0.8f, 0.0f, 0.0f);
-                }
-                
-                // Draw main body
-                glBegin(GL_QUADS);
-                glVertex2f(e.x - 15, e.y - 15);
-                glVertex2f(e.x + 15, e.y - 15);
-                glVertex2f(e.x + 15, e.y + 15);
-                glVertex2f(e.x - 15, e.y + 15);
-                glEnd();
-                
-                // Draw health indicator for tanks
-                if (e.type == 2 && e.health > 0) {
-                    glColor3f(1.0f, 1.0f, 1.0f);
-                    glBegin(GL_LINE_LOOP);
-                    glVertex2f(e.x - 18, e.y - 18);
-                    glVertex2f(e.x + 18, e.y - 18);
-                    glVertex2f(e.x + 18, e.y + 18);
-                    glVertex2f(e.x - 18, e.y + 18);
-                    glEnd();
-                }
+    }
+    
+    sprites.flush();
+    
+    // Particles, in one instanced draw
+    particles.draw(game.particles);
+}
+
+// Runs the simulation without a window as fast as the controller allows
+static int runHeadless(Controller& controller, uint32_t seed, uint64_t maxTicks, int threads, const char* audioPath)
+{
+    GameState game(seed);
+    JobSystem jobs(threads > 0 ? threads : 0);
+    game.jobs = &jobs;
+    
+    // Audio follows game time here, so the file matches the game whatever the speed
+    WavAudioSink audioSink;
+    std::unique_ptr<AudioMixer> audio;
+    if (audioPath) {
+        if (!audioSink.open(audioPath)) return -1;
+        audio.reset(new AudioMixer(audioSink, AudioMixer::kClockGameTime));
+        game.audio = audio.get();
+    }
+    
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    // Steps, not game.tick, bound the run: paused steps don't advance the game
+    for (uint64_t step = 0; step < maxTicks && !game.gameOver; step++) {
+        game.handleInput(controller.nextAction(game));
+        game.update(kTickDt);
+    }
+    if (audio) audio->stop();  // Finishes mixing every tick
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    if (audio) {
+        printf("Audio: %llu sounds (%llu dropped), %.1f s written to %s\n",
+               (unsigned long long)audio->playedCommands(), (unsigned long long)audio->droppedCommands(),
+               (double)audioSink.frames() / kAudioSampleRate, audioPath);
+    }
+    printf("%llu ticks in %.3f s (%.0f ticks/s, %.1fx real time)\n", (unsigned long long)game.tick, seconds,
+           game.tick / seconds, game.tick * kTickDt / seconds);
+    printf("Score: %d | Wave: %d | Lives: %d%s\n", game.score, game.wave, game.lives,
+           game.gameOver ? " | game over" : "");
+    return 0;
+}
+
+static const char* kUsage =
+    "Usage: %s [options]\n"
+    "  --capture <file.y4m|frame_%%05d.png>  Record every rendered frame\n"
+    "  --threads <n>                        Simulation worker threads (default: cores - 1)\n"
+    "  --profile                            Print startup and frame phase timings to stderr\n"
+    "  --speed <1|2|8|max>                  Simulation ticks per rendered frame (F cycles)\n"
+    "  --max-frames-in-flight <1-3>         Wait for the GPU so at most n frames are queued\n"
+    "  --telemetry <file>                   Log per-frame stats to a telemetry ring (off by default;\n"
+    "                                       read it with space_invaders_telemetry)\n"
+    "  --latency-log <file.csv>             Log input-to-photon latency per frame, print a histogram\n"
+    "  --audio-wav <file.wav>               Mix sound effects into a WAV file (in game time when headless)\n"
+#ifndef _WIN32
+    "  --leaderboard [socket]               Submit scores to the leaderboard daemon instead of\n"
+    "                                       highscores.txt (default: " LEADERBOARD_DEFAULT_SOCKET ")\n"
+#endif
+    "  --seed <n>                           Random seed (default: time)\n"
+    "  --bot                                Let the built-in bot play\n"
+    "  --script <file>                      Play a script of \"<ticks> [left|right] [fire] [pause]\" lines\n"
+    "  --replay <file>                      Play back a recorded game\n"
+    "  --record <file>                      Record the game's actions for --replay\n"
+    "  --headless <ticks>                   Simulate without a window (bot unless --script/--replay)\n"
+    "  --check-allocs [frames]              Run for a number of frames (default 600) and fail\n"
+    "                                       if update or render allocate after warmup\n";
+
+// Fast-forward settings cycled by the F key; 0 means as many ticks as fit in a frame
+static const int kSpeeds[] = {1, 2, 8, 0};
+static const int kSpeedCount = sizeof(kSpeeds) / sizeof(kSpeeds[0]);
+
+// Frames before --check-allocs expects update and render to stop allocating
+static const int kAllocWarmupFrames = 120;
+
+// GLFW allocator hooks, so allocations inside GLFW are tracked too
+static void* glfwTrackedAllocate(size_t size, void*) { return trackedMalloc(size); }
+static void* glfwTrackedReallocate(void* block, size_t size, void*) { return trackedRealloc(block, size); }
+static void glfwTrackedDeallocate(void* block, void*) { trackedFree(block); }
+
+// Queues key presses and releases for the simulation; repeats carry no new information
+static void keyCallback(GLFWwindow* window, int key, int, int action, int) {
+    if (action == GLFW_REPEAT) return;
+    InputQueue* input = static_cast<InputQueue*>(glfwGetWindowUserPointer(window));
+    input->push(key, action == GLFW_PRESS, glfwGetTime());
+}
+
+int main(int argc, char* argv[])
+{
+    StartupTimer startup;
+    uint32_t seed = (uint32_t)time(0);
+
+    // Command line options
+    const char* capturePath = nullptr;
+    const char* latencyPath = nullptr;
+    const char* audioPath = nullptr;
+    const char* telemetryPath = nullptr;
+    const char* leaderboardSocket = nullptr;
+    int threads = (int)std::thread::hardware_concurrency() - 1;
+    bool profile = false;
+    int speedIndex = 0;
+    int checkAllocFrames = 0;  // 0: not checking
+    int maxFramesInFlight = 0;  // 0: let the driver decide
+    bool useBot = false;
+    const char* scriptPath = nullptr;
+    const char* replayPath = nullptr;
+    const char* recordPath = nullptr;
+    long long headlessTicks = 0;  // 0: play in a window
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            capturePath = argv[++i];  // .y4m stream or .png sequence
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--bot") == 0) {
+            useBot = true;
+        } else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+            scriptPath = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (strcmp(argv[i], "--headless") == 0 && i + 1 < argc) {
+            headlessTicks = atoll(argv[++i]);
+            if (headlessTicks <= 0) {
+                fprintf(stderr, kUsage, argv[0]);
+                return -1;
             }
-        }
-        
-        // Draw power-ups with different colors and glowing effect
-        for (const auto& p : powerUps) {
-            if (p.active) {
-                float r, g, b;
-                switch (p.type) {
-                    case 0: r = 0.3f; g = 0.8f; b = 1.0f; break;  // Shield: Cyan
-                    case 1: r = 1.0f; g = 0.8f; b = 0.0f; break;  // Rapid Fire: Orange
-                    case 2: r = 1.0f; g = 0.0f; b = 1.0f; break;  // Multi-shot: Magenta
-                    case 3: r = 0.5f; g = 0.0f; b = 1.0f; break;  // Slow Motion: Purple
-                    default: r = 1.0f; g = 1.0f; b = 1.0f;
-                }
-                
-                glColor3f(r, g, b);
-                glBegin(GL_QUADS);
-                glVertex2f(p.x - 8, p.y - 8);
-                glVertex2f(p.x + 8, p.y - 8);
-                glVertex2f(p.x + 8, p.y + 8);
-                glVertex2f(p.x - 8, p.y + 8);
-                glEnd();
-                
-                // Draw glowing outline
-                glColor3f(r * 1.5f, g * 1.5f, b * 1.5f);
-                glBegin(GL_LINE_LOOP);
-                glVertex2f(p.x - 12, p.y - 12);
-                glVertex2f(p.x + 12, p.y - 12);
-                glVertex2f(p.x + 12, p.y + 12);
-                glVertex2f(p.x - 12, p.y + 12);
-                glEnd();
+        } else if (strcmp(argv[i], "--max-frames-in-flight") == 0 && i + 1 < argc) {
+            maxFramesInFlight = atoi(argv[++i]);
+            if (maxFramesInFlight < 1 || maxFramesInFlight > FramePacer::kMaxFramesInFlight) {
+                fprintf(stderr, kUsage, argv[0]);
+                return -1;
             }
-        }
-        
-        // Draw player bullets (yellow)
-        glColor3f(1.0f, 1.0f, 0.0f);
-        for (const auto& b : playerBullets) {
-            if (b.active) {
-                glBegin(GL_QUADS);
-                glVertex2f(b.x - 2, b.y - 8);
-                glVertex2f(b.x + 2, b.y - 8);
-                glVertex2f(b.x + 2, b.y + 8);
-                glVertex2f(b.x - 2, b.y + 8);
-                glEnd();
+#ifndef _WIN32
+        } else if (strcmp(argv[i], "--leaderboard") == 0) {
+            leaderboardSocket = LEADERBOARD_DEFAULT_SOCKET;
+            if (i + 1 < argc && argv[i + 1][0] != '-') leaderboardSocket = argv[++i];
+#endif
+        } else if (strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetryPath = argv[++i];
+        } else if (strcmp(argv[i], "--latency-log") == 0 && i + 1 < argc) {
+            latencyPath = argv[++i];
+        } else if (strcmp(argv[i], "--audio-wav") == 0 && i + 1 < argc) {
+            audioPath = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            profile = true;
+        } else if (strcmp(argv[i], "--check-allocs") == 0) {
+            checkAllocFrames = 600;
+            if (i + 1 < argc && atoi(argv[i + 1]) > 0) checkAllocFrames = atoi(argv[++i]);
+            if (checkAllocFrames <= kAllocWarmupFrames) checkAllocFrames = kAllocWarmupFrames + 1;
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            const char* speed = argv[++i];
+            int ticks = strcmp(speed, "max") == 0 ? 0 : atoi(speed);
+            speedIndex = -1;
+            for (int s = 0; s < kSpeedCount; s++) {
+                if (kSpeeds[s] == ticks) speedIndex = s;
             }
-        }
-        
-        // Draw enemy bullets (orange)
-        glColor3f(1.0f, 0.5f, 0.0f);
-        for (const auto& b : enemyBullets) {
-            if (b.active) {
-                glBegin(GL_QUADS);
-                glVertex2f(b.x - 2, b.y - 8);
-                glVertex2f(b.x + 2, b.y - 8);
-                glVertex2f(b.x + 2, b.y + 8);
-                glVertex2f(b.x - 2, b.y + 8);
-                glEnd();
+            if (speedIndex < 0) {
+                fprintf(stderr, kUsage, argv[0]);
+                return -1;
             }
-        }
-        
-        // Draw pause indicator
-        if (paused) {
-            glColor3f(1.0f, 1.0f, 1.0f);
-            // Draw simple text representation: display via console
-            printf(" [PAUSED]");
+        } else {
+            fprintf(stderr, kUsage, argv[0]);
+            return -1;
         }
     }
-};
-
-int main(int argc, char* argv[])
-{
-    srand((unsigned int)time(0));
 
+    // Pick who plays. A replay carries the seed of the game it recorded.
+    BotController bot;
+    ScriptedController script;
+    ReplayController replay;
+    Controller* controller = useBot || headlessTicks ? &bot : nullptr;
+    if (scriptPath) {
+        if (!script.open(scriptPath)) return -1;
+        controller = &script;
+    }
+    if (replayPath) {
+        if (!replay.open(replayPath)) return -1;
+        seed = replay.seed();
+        controller = &replay;
+    }
+    
+    std::unique_ptr<RecordingController> recorder;
+    if (headlessTicks) {
+        if (recordPath) {
+            recorder.reset(new RecordingController(*controller, recordPath, seed));
+            controller = recorder.get();
+        }
+        return runHeadless(*controller, seed, (uint64_t)headlessTicks, threads, audioPath);
+    }
+    
+    // Everything that doesn't need the GL context is prepared on another
+    // thread while the window and context come up
+    HighScoreTable highScores;
+    std::unique_ptr<GameState> gameStorage;
+    std::unique_ptr<JobSystem> jobs;
+    TelemetryFile telemetry;
+    WavAudioSink audioSink;
+    std::unique_ptr<AudioMixer> audio;
+    double backgroundSeconds = 0;
+    std::thread preparing([&] {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        loadHighScores(highScores);
+        gameStorage.reset(new GameState(seed));
+        jobs.reset(new JobSystem(threads > 0 ? threads : 0));
+        // Ten minutes of frames; older ones are overwritten
+        if (telemetryPath) telemetry.create(telemetryPath, 60 * 60 * 10);
+        if (audioPath && audioSink.open(audioPath)) audio.reset(new AudioMixer(audioSink, AudioMixer::kClockRealTime));
+        backgroundSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    });
+    startup.step("options");
+    
     GLFWwindow* window;
 
-    if (!glfwInit()) return -1;
+    GLFWallocator allocator = {glfwTrackedAllocate, glfwTrackedReallocate, glfwTrackedDeallocate, nullptr};
+    glfwInitAllocator(&allocator);
+    if (!glfwInit()) {
+        preparing.join();
+        return -1;
+    }
+    startup.step("glfw_init");
 
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_COMPAT_PROFILE);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -585,19 +372,35 @@ int main(int argc, char* argv[])
     if(!window)
     {
         glfwTerminate();
+        preparing.join();
         return -1;
     }
 
     glfwMakeContextCurrent(window);
     glfwSwapInterval(1); // Enable vsync
+    startup.step("window");
+    
+    InputQueue input;
+    glfwSetWindowUserPointer(window, &input);
+    glfwSetKeyCallback(window, keyCallback);
+    KeyboardController keyboard(input);
+    bool keyboardPlays = !controller;
+    if (!controller) controller = &keyboard;
+    if (recordPath) {
+        recorder.reset(new RecordingController(*controller, recordPath, seed));
+        controller = recorder.get();
+    }
 
-    GLenum err = glewInit();
-    if(err != GLEW_OK)
+    // glad resolves only the GL 3.3 compatibility entry points the game can
+    // use, rather than every function and extension the driver knows
+    if(!gladLoadGL(glfwGetProcAddress))
     {
-        fprintf(stderr, "Error initializing GLEW.\n");
+        fprintf(stderr, "Could not load OpenGL functions.\n");
         glfwTerminate();
+        preparing.join();
         return -1;
     }
+    startup.step("gl_loader");
     int glVersion[2] = {-1, 1};
     glGetIntegerv(GL_MAJOR_VERSION, &glVersion[0]);
     glGetIntegerv(GL_MINOR_VERSION, &glVersion[1]);
@@ -607,24 +410,75 @@ int main(int argc, char* argv[])
     printf("Using OpenGL: %d.%d\n", glVersion[0], glVersion[1]);
     printf("Renderer used: %s\n", glGetString(GL_RENDERER));
     printf("Shading Language: %s\n", glGetString(GL_SHADING_LANGUAGE_VERSION));
+    startup.step("gl_info");
 
     // Setup OpenGL state
-    glViewport(0, 0, 640, 480);
-    glMatrixMode(GL_PROJECTION);
-    glOrtho(0, 640, 480, 0, -1, 1);
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
+    glViewport(0, 0, 640, 480);  // The shaders map game coordinates themselves
     
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
-    // Create game state
-    GameState game;
+    std::unique_ptr<StarfieldRenderer> starfieldRenderer(new StarfieldRenderer(640, 480));
+    std::unique_ptr<BunkerRenderer> bunkerRenderer(new BunkerRenderer(640, 480));
+    std::unique_ptr<SpriteRenderer> spriteRenderer(new SpriteRenderer(640, 480));
+    std::unique_ptr<ParticleRenderer> particleRenderer(new ParticleRenderer(640, 480));
+    startup.step("gl_setup");
+    
+    // Pick up the game prepared in the background
+    preparing.join();
+    startup.step("wait_background");
+    startup.add("background", backgroundSeconds);
+    GameState& game = *gameStorage;
+    game.jobs = jobs.get();
+    game.audio = audio.get();
+
+    Profiler profiler;
+    profiler.enabled = profile;
+    const int inputPhase = profiler.phase("input");
+    const int updatePhase = profiler.phase("update");
+    const int renderPhase = profiler.phase("render");
+    const int capturePhase = profiler.phase("capture");
+    const int swapPhase = profiler.phase("swap");
+    const int gpuWaitPhase = profiler.phase("gpu_wait");
+    const int jobsCounter = profiler.counter("jobs");
+    const int stealsCounter = profiler.counter("steals");
+    const int idleCounter = profiler.counter("worker_idle_ms");
+    const int ticksCounter = profiler.counter("ticks");
+    const int particlesCounter = profiler.counter("particles");
+    const int inputLatencySample = profiler.sample("input_latency_ms");
+    const int allocsCounter = profiler.counter("allocs");
+    const int allocKbCounter = profiler.counter("alloc_kb");
+    const int peakKbCounter = profiler.counter("heap_peak_kb");
+    const int updateAllocsCounter = profiler.counter("update_allocs");
+    const int renderAllocsCounter = profiler.counter("render_allocs");
+    int frame = 0;
+    uint64_t steadyAllocs = 0;  // Update/render allocations after warmup
+
+    FrameCapture capture;
+    if (capturePath) {
+        int fbWidth, fbHeight;
+        glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+        capture.start(capturePath, fbWidth, fbHeight, 60);
+    }
+    
+#ifndef _WIN32
+    // Scores go to the shared daemon; undeliverable ones wait in a local queue file
+    std::unique_ptr<LeaderboardClient> leaderboard;
+    if (leaderboardSocket) leaderboard.reset(new LeaderboardClient(leaderboardSocket, "leaderboard_queue.txt"));
+#endif
+    
+    const double telemetryStart = glfwGetTime();
+    uint64_t telemetryFrame = 0;
+    
+    FramePacer pacer(maxFramesInFlight);
+    LatencyProbe latencyProbe;
+    if (latencyPath) latencyProbe.start(latencyPath);
     
-    // Set up timing for consistent frame rate (60 FPS)
-    double lastTime = glfwGetTime();
+    // Set up timing for consistent frame rate (60 FPS). The first frame
+    // goes out right away rather than a frame period after startup.
     const double targetFrameTime = 1.0 / 60.0; // 60 FPS
+    double lastTime = glfwGetTime() - targetFrameTime;
     
     while (!glfwWindowShouldClose(window))
     {
@@ -633,31 +487,135 @@ int main(int argc, char* argv[])
         
         // Limit frame rate to 60 FPS
         if (deltaTime < targetFrameTime) {
+            glfwPollEvents();  // Timestamp input as it arrives while waiting
+            latencyProbe.poll();
             continue;
         }
         
         lastTime = currentTime;
+        AllocStats frameStart = allocStats();
+        resetAllocPeak();
+        
+        // Keep the GPU queue short before sampling input for the next frame
+        if (pacer.enabled()) {
+            ProfileScope scope(profiler, gpuWaitPhase);
+            latencyProbe.paced(pacer.waitForQueue());
+        }
+        
+        // Collect input right before simulating rather than after the swap,
+        // so it isn't held back a frame
+        glfwPollEvents();
         
-        // Handle input and update game
-        game.handleInput(window);
-        game.update((float)deltaTime);
-        game.render();
+        // Cycle fast-forward speed for each F press queued since the last frame
+        if (!keyboardPlays) keyboard.drain();
+        speedIndex = (speedIndex + keyboard.takeSpeedPresses()) % kSpeedCount;
         
-        // Print stats
-        printf("\rWave: %d | Score: %d | Lives: %d | Enemies: %d", game.wave, game.score, game.lives, 
-               (int)std::count_if(game.enemies.begin(), game.enemies.end(), 
-                            [](const Enemy& e) { return e.active; }));
-        fflush(stdout);
+        // Handle input and update game, one or more fixed ticks per frame.
+        // At max speed keep ticking until most of the frame budget is used.
+        int speed = kSpeeds[speedIndex];
+        int ticks = 0;
+        uint64_t updateAllocs = 0;
+        double updateSeconds = 0;
+        latencyProbe.beginFrame(glfwGetTime());
+        while (!game.gameOver) {
+            {
+                ProfileScope scope(profiler, inputPhase);
+                game.handleInput(controller->nextAction(game));
+            }
+            {
+                ProfileScope scope(profiler, updatePhase);
+                uint64_t before = allocStats().allocations;
+                double updateStart = glfwGetTime();
+                game.update(kTickDt);
+                updateSeconds += glfwGetTime() - updateStart;
+                updateAllocs += allocStats().allocations - before;
+            }
+            ticks++;
+            if (game.paused) break;
+            if (speed > 0 ? ticks >= speed : glfwGetTime() - currentTime > targetFrameTime * 0.75) break;
+        }
+        profiler.addCount(ticksCounter, ticks);
+        for (int i = 0; i < input.consumedCount(); i++) latencyProbe.eventConsumed(input.consumedTime(i));
+        InputQueue::Latency latency = input.takeLatency();
+        profiler.addSamples(inputLatencySample, latency.events, latency.totalSeconds * 1000.0,
+                            latency.maxSeconds * 1000.0);
+        profiler.addCount(particlesCounter, (double)game.particles.size());
+        uint64_t renderAllocs = allocStats().allocations;
+        double renderStart = glfwGetTime();
+        {
+            ProfileScope scope(profiler, renderPhase);
+            render(game, *starfieldRenderer, *bunkerRenderer, *spriteRenderer, *particleRenderer);
+        }
+        double renderEnd = glfwGetTime();
+        renderAllocs = allocStats().allocations - renderAllocs;
+        latencyProbe.submitted(renderEnd);
+        {
+            ProfileScope scope(profiler, capturePhase);
+            capture.capture();
+        }
+        
+        JobSystem::Stats jobStats = jobs->takeStats();
+        profiler.addCount(jobsCounter, (double)jobStats.jobs);
+        profiler.addCount(stealsCounter, (double)jobStats.steals);
+        profiler.addCount(idleCounter, jobStats.idleSeconds * 1000.0);
+        
+        AllocStats frameEnd = allocStats();
+        profiler.addCount(allocsCounter, (double)(frameEnd.allocations - frameStart.allocations));
+        profiler.addCount(allocKbCounter, (frameEnd.bytes - frameStart.bytes) / 1024.0);
+        profiler.addCount(peakKbCounter, frameEnd.peak / 1024.0);
+        profiler.addCount(updateAllocsCounter, (double)updateAllocs);
+        profiler.addCount(renderAllocsCounter, (double)renderAllocs);
+        if (checkAllocFrames && frame >= kAllocWarmupFrames && updateAllocs + renderAllocs > 0) {
+            fprintf(stderr, "\n[check-allocs] frame %d: update allocated %llu times, render %llu times\n", frame,
+                    (unsigned long long)updateAllocs, (unsigned long long)renderAllocs);
+            steadyAllocs += updateAllocs + renderAllocs;
+        }
+        
+        // Record stats; space_invaders_telemetry --follow shows them live
+        TelemetryRecord record;
+        record.frame = telemetryFrame++;
+        record.time = currentTime - telemetryStart;
+        record.frameMs = (float)(deltaTime * 1000.0);
+        record.updateMs = (float)(updateSeconds * 1000.0);
+        record.renderMs = (float)((renderEnd - renderStart) * 1000.0);
+        record.ticks = (uint16_t)ticks;
+        record.speed = (uint8_t)speed;
+        record.flags = (game.paused ? kTelemetryPaused : 0) | (game.gameOver ? kTelemetryGameOver : 0) |
+                       (game.shieldActive > 0 ? kTelemetryShield : 0) |
+                       (game.rapidFireActive > 0 ? kTelemetryRapidFire : 0) |
+                       (game.multiShotActive > 0 ? kTelemetryMultiShot : 0) |
+                       (game.slowMotionActive > 0 ? kTelemetrySlowMotion : 0);
+        record.enemies = (uint32_t)game.enemies.liveCount();
+        record.playerBullets = (uint32_t)game.playerBullets.size();
+        record.enemyBullets = (uint32_t)game.enemyBullets.size();
+        record.powerUps = (uint32_t)game.powerUps.size();
+        record.particles = (uint32_t)game.particles.size();
+        record.allocations = (uint32_t)(frameEnd.allocations - frameStart.allocations);
+        record.allocBytes = (uint32_t)(frameEnd.bytes - frameStart.bytes);
+        record.wave = game.wave;
+        record.score = game.score;
+        record.lives = game.lives;
+        telemetry.write(record);
         
         if (game.gameOver) {
-            printf("\n\n========== GAME OVER ==========\n");
+            printf("\n========== GAME OVER ==========\n");
             printf("Final Score: %d\n", game.score);
             printf("Wave Reached: %d\n", game.wave);
             
+#ifndef _WIN32
+            // Show the shared board when the daemon has sent one
+            LeaderboardEntry shared[10];
+            int sharedCount = leaderboard ? leaderboard->top(shared, 10) : -1;
+            for (int i = 0; i < 10 && sharedCount >= 0; i++) {
+                highScores[i] = i < sharedCount ? HighScore{shared[i].score, shared[i].wave} : HighScore{0, 0};
+            }
+            if (leaderboard && game.score > 0) leaderboard->submit(game.score, game.wave);
+#endif
+            
             // Check if high score
             bool isHighScore = false;
             for (int i = 0; i < 10; i++) {
-                if (game.score > game.highScores[i].score) {
+                if (game.score > highScores[i].score) {
                     isHighScore = true;
                     break;
                 }
@@ -665,13 +623,17 @@ int main(int argc, char* argv[])
             
             if (isHighScore) {
                 printf("\n*** NEW HIGH SCORE! ***\n");
-                insertHighScore(game.highScores, game.score, game.wave);
+#ifndef _WIN32
+                if (leaderboard) placeHighScore(highScores, game.score, game.wave);
+                else
+#endif
+                insertHighScore(highScores, game.score, game.wave);
             }
             
             printf("\n===== TOP 10 HIGH SCORES =====\n");
             for (int i = 0; i < 10; i++) {
-                if (game.highScores[i].score > 0) {
-                    printf("%d. %d (Wave %d)\n", i + 1, game.highScores[i].score, game.highScores[i].wave);
+                if (highScores[i].score > 0) {
+                    printf("%d. %d (Wave %d)\n", i + 1, highScores[i].score, highScores[i].wave);
                 }
             }
             printf("\nPress any key to exit...\n");
@@ -679,12 +641,42 @@ int main(int argc, char* argv[])
             break;
         }
 
-        glfwSwapBuffers(window);
+        {
+            ProfileScope scope(profiler, swapPhase);
+            glfwSwapBuffers(window);
+        }
+        pacer.frameSubmitted();
+        latencyProbe.swapped(glfwGetTime());
+        if (frame == 0) {
+            startup.step("first_frame");
+            if (profile) startup.print();
+        }
 
-        glfwPollEvents();
+        profiler.endFrame();
+        if (++frame == checkAllocFrames) break;
     }
 
+    capture.stop();
+    latencyProbe.stop();
+    pacer.release();
+    starfieldRenderer.reset();  // GL objects go before the context
+    bunkerRenderer.reset();
+    spriteRenderer.reset();
+    particleRenderer.reset();
     glfwDestroyWindow(window);
     glfwTerminate();
+    
+    if (audio) {
+        audio->stop();
+        printf("Audio: %llu sounds (%llu dropped, %llu late periods), %.1f s written to %s\n",
+               (unsigned long long)audio->playedCommands(), (unsigned long long)audio->droppedCommands(),
+               (unsigned long long)audio->latePeriods(), (double)audioSink.frames() / kAudioSampleRate, audioPath);
+    }
+    
+    if (checkAllocFrames) {
+        printf("\n[check-allocs] %s: %llu allocations in update/render after %d warmup frames (%d frames run)\n",
+               steadyAllocs ? "FAILED" : "passed", (unsigned long long)steadyAllocs, kAllocWarmupFrames, frame);
+        return steadyAllocs ? 1 : 0;
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,204 @@
+#pragma once
+
+// Small pixel observations of a game, drawn on the CPU.
+//
+// Rasterizes a GameState straight from its entity arrays into a uint8 image
+// a few dozen pixels across (84x84 by default), either as one gray plane
+// with a distinct level per kind of object or as one 0/255 mask plane per
+// RasterChannel. No GL and no readback, so it costs a few microseconds per
+// game and runs on any thread; the batch environment draws each game's
+// pixels on the worker that stepped it.
+//
+// Shapes follow render(): boxes for enemies, bullets and power-ups, a
+// triangle for the ship, and a pixel wherever bunker cells under it are
+// solid. Bullet and power-up boxes are mapped to pixel spans with SSE2,
+// two (x, y) centers per register and four boxes per loop iteration, and
+// every span is filled with memset.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RASTER_SSE2 1
+#endif
+
+#include "game_state.h"
+
+// Mask planes, in this order, when RasterFormat::channels is set
+enum RasterChannel {
+    kRasterPlayer,
+    kRasterEnemies,
+    kRasterPlayerBullets,
+    kRasterEnemyBullets,
+    kRasterPowerUps,
+    kRasterBunkers,
+    kRasterChannelCount,
+};
+
+struct RasterFormat {
+    int width = 84;
+    int height = 84;
+    bool channels = false;  // Mask planes instead of one gray plane
+
+    size_t planeBytes() const { return (size_t)width * height; }
+    size_t bytes() const { return planeBytes() * (channels ? kRasterChannelCount : 1); }
+};
+
+// Gray levels per kind of object; enemies step up by type
+constexpr uint8_t kRasterGrayPlayer = 255;
+constexpr uint8_t kRasterGrayEnemy = 64;
+constexpr uint8_t kRasterGrayEnemyStep = 32;
+constexpr uint8_t kRasterGrayPlayerBullet = 224;
+constexpr uint8_t kRasterGrayEnemyBullet = 192;
+constexpr uint8_t kRasterGrayPowerUp = 160;
+constexpr uint8_t kRasterGrayBunker = 40;
+
+class ObservationRaster {
+public:
+    explicit ObservationRaster(const RasterFormat& format = RasterFormat())
+        : format(format), scaleX(format.width / 640.0f), scaleY(format.height / 480.0f) {}
+
+    const RasterFormat& rasterFormat() const { return format; }
+
+    // Overwrites format.bytes() bytes at `out`
+    void draw(const GameState& game, uint8_t* out) const {
+        memset(out, 0, format.bytes());
+        drawBunkers(game.bunkers, plane(out, kRasterBunkers), format.channels ? 255 : kRasterGrayBunker);
+
+        uint8_t* player = plane(out, kRasterPlayer);
+        drawShip(game.playerX, game.playerY, player, format.channels ? 255 : kRasterGrayPlayer);
+
+        const Formation& enemies = game.enemies;
+        for (int t = 0; t < kEnemyTypeCount; t++) {
+            uint8_t value = format.channels ? 255 : (uint8_t)(kRasterGrayEnemy + t * kRasterGrayEnemyStep);
+            for (int row = 0; row < (int)enemies.rows.size(); row++) {
+                float ey = enemies.cellY(row);
+                uint64_t mask = enemies.rows[row].type[t];
+                while (mask) {
+                    float ex = enemies.cellX(lowestBit(mask));
+                    mask &= mask - 1;
+                    fillBox(ex - 15, ey - 15, ex + 15, ey + 15, plane(out, kRasterEnemies), value);
+                }
+            }
+        }
+
+        drawBoxes(game.powerUps.get<Position>(), game.powerUps.aliveFlags(), game.powerUps.size(), 8, 8,
+                  plane(out, kRasterPowerUps), format.channels ? 255 : kRasterGrayPowerUp);
+        drawBoxes(game.playerBullets.get<Position>(), game.playerBullets.aliveFlags(), game.playerBullets.size(), 2,
+                  8, plane(out, kRasterPlayerBullets), format.channels ? 255 : kRasterGrayPlayerBullet);
+        drawBoxes(game.enemyBullets.get<Position>(), game.enemyBullets.aliveFlags(), game.enemyBullets.size(), 2,
+                  8, plane(out, kRasterEnemyBullets), format.channels ? 255 : kRasterGrayEnemyBullet);
+    }
+
+private:
+    // Gray output draws everything into its single plane, later kinds on top
+    uint8_t* plane(uint8_t* out, RasterChannel channel) const {
+        return format.channels ? out + channel * format.planeBytes() : out;
+    }
+
+    // Pixel spans are inclusive and at least one pixel wide, so objects
+    // smaller than a pixel still show up
+    void fillSpan(int x0, int x1, int y0, int y1, uint8_t* pixels, uint8_t value) const {
+        x0 = std::max(x0, 0);
+        y0 = std::max(y0, 0);
+        x1 = std::min(x1, format.width - 1);
+        y1 = std::min(y1, format.height - 1);
+        if (x0 > x1) return;
+        for (int y = y0; y <= y1; y++) memset(pixels + (size_t)y * format.width + x0, value, x1 - x0 + 1);
+    }
+
+    static int floorToInt(float v) {
+        int i = (int)v;
+        return i > v ? i - 1 : i;
+    }
+
+    void fillBox(float minX, float minY, float maxX, float maxY, uint8_t* pixels, uint8_t value) const {
+        fillSpan(floorToInt(minX * scaleX), floorToInt(maxX * scaleX), floorToInt(minY * scaleY),
+                 floorToInt(maxY * scaleY), pixels, value);
+    }
+
+    // Boxes of half size (halfW, halfH) around every live position
+    void drawBoxes(const Position* pos, const uint8_t* alive, size_t count, float halfW, float halfH,
+                   uint8_t* pixels, uint8_t value) const {
+        size_t i = 0;
+#ifdef RASTER_SSE2
+        // Positions are (x, y) pairs: two entities per register. Scale the
+        // box corners, clamp them to [-1, size] and floor through a +1 bias
+        // so truncation rounds down.
+        const __m128 scale = _mm_setr_ps(scaleX, scaleY, scaleX, scaleY);
+        const __m128 lowOffset = _mm_setr_ps(-halfW, -halfH, -halfW, -halfH);
+        const __m128 highOffset = _mm_setr_ps(halfW, halfH, halfW, halfH);
+        const __m128 lowest = _mm_set1_ps(-1.0f);
+        const __m128 highest = _mm_setr_ps((float)format.width, (float)format.height, (float)format.width,
+                                           (float)format.height);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128i oneInt = _mm_set1_epi32(1);
+        for (; i + 4 <= count; i += 4) {
+            alignas(16) int32_t low[8], high[8];
+            for (int half = 0; half < 2; half++) {
+                __m128 xy = _mm_loadu_ps(&pos[i + half * 2].x);
+                __m128 lo = _mm_mul_ps(_mm_add_ps(xy, lowOffset), scale);
+                __m128 hi = _mm_mul_ps(_mm_add_ps(xy, highOffset), scale);
+                lo = _mm_min_ps(_mm_max_ps(lo, lowest), highest);
+                hi = _mm_min_ps(_mm_max_ps(hi, lowest), highest);
+                _mm_store_si128((__m128i*)&low[half * 4],
+                                _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(lo, one)), oneInt));
+                _mm_store_si128((__m128i*)&high[half * 4],
+                                _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(hi, one)), oneInt));
+            }
+            for (int k = 0; k < 4; k++) {
+                if (alive[i + k]) fillSpan(low[k * 2], high[k * 2], low[k * 2 + 1], high[k * 2 + 1], pixels, value);
+            }
+        }
+#endif
+        for (; i < count; i++) {
+            if (alive[i]) fillBox(pos[i].x - halfW, pos[i].y - halfH, pos[i].x + halfW, pos[i].y + halfH, pixels, value);
+        }
+    }
+
+    // Per pixel row over the band, the runs of columns solid in any of the
+    // cell rows it covers, each filled as one span. Most rows cover the same
+    // columns as the row above and copy it instead; nothing else is drawn yet,
+    // so the row holds only bunker pixels.
+    void drawBunkers(const Bunkers& bunkers, uint8_t* pixels, uint8_t value) const {
+        int y0 = std::max(floorToInt(kBunkerTop * scaleY), 0);
+        int y1 = std::min(floorToInt(kBunkerBottom * scaleY), format.height - 1);
+        float cellScaleX = kBunkerCellSize * scaleX;
+        uint64_t merged[kBunkerWords], previous[kBunkerWords];
+        int previousRow = -1;
+        for (int py = y0; py <= y1; py++) {
+            int r0 = std::max(floorToInt((py / scaleY - kBunkerTop) / kBunkerCellSize), 0);
+            int r1 = std::min(floorToInt(((py + 1) / scaleY - kBunkerTop) / kBunkerCellSize - 0.01f), kBunkerRows - 1);
+            if (r0 > r1) continue;
+            bunkers.mergeRows(r0, r1, merged);
+            uint8_t* row = pixels + (size_t)py * format.width;
+            if (previousRow >= 0 && memcmp(merged, previous, sizeof(merged)) == 0) {
+                memcpy(row, pixels + (size_t)previousRow * format.width, format.width);
+                continue;
+            }
+            Bunkers::forEachRun(merged, [&](int first, int last) {
+                fillSpan(floorToInt(first * cellScaleX), floorToInt((last + 1) * cellScaleX - 0.01f), py, py, pixels,
+                         value);
+            });
+            memcpy(previous, merged, sizeof(merged));
+            previousRow = py;
+        }
+    }
+
+    // The ship's triangle, apex at (x, y - 25) widening to 40 px at y + 20
+    void drawShip(float x, float y, uint8_t* pixels, uint8_t value) const {
+        int y0 = std::max(floorToInt((y - 25) * scaleY), 0);
+        int y1 = std::min(floorToInt((y + 20) * scaleY), format.height - 1);
+        for (int py = y0; py <= y1; py++) {
+            float rowBottom = std::min((py + 1) / scaleY, y + 20);
+            float half = 20.0f * (rowBottom - (y - 25)) / 45.0f;
+            fillSpan(floorToInt((x - half) * scaleX), floorToInt((x + half) * scaleX), py, py, pixels, value);
+        }
+    }
+
+    RasterFormat format;
+    float scaleX, scaleY;
+};
@@ -0,0 +1,113 @@
+#pragma once
+
+// Instanced particle drawing.
+//
+// Every particle is an instance of one unit quad. The pool's position, life
+// and color arrays are copied into a single streaming buffer, one region per
+// attribute, and the whole pool is drawn with one glDrawArraysInstanced.
+// The shader maps game coordinates (640x480, y down) to clip space itself.
+// Requires a GL 3.3 context with its functions loaded.
+
+#include <glad/gl.h>
+
+#include "gl_shader.h"
+#include "particles.h"
+
+class ParticleRenderer {
+public:
+    ParticleRenderer(float viewWidth, float viewHeight) {
+        program = buildProgram("Particle", kVertexShader, kFragmentShader);
+        if (!program) return;
+        glUseProgram(program);
+        glUniform2f(glGetUniformLocation(program, "viewSize"), viewWidth, viewHeight);
+        glUseProgram(0);
+
+        static const float corners[8] = {-1, -1, 1, -1, -1, 1, 1, 1};
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &quadBuffer);
+        glGenBuffers(1, &instanceBuffer);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, quadBuffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    ~ParticleRenderer() {
+        glDeleteBuffers(1, &instanceBuffer);
+        glDeleteBuffers(1, &quadBuffer);
+        glDeleteVertexArrays(1, &vao);
+        glDeleteProgram(program);
+    }
+
+    ParticleRenderer(const ParticleRenderer&) = delete;
+    ParticleRenderer& operator=(const ParticleRenderer&) = delete;
+
+    void draw(const ParticlePool& pool) {
+        size_t count = pool.size();
+        if (!program || count == 0) return;
+
+        // Orphan last frame's storage, then upload each attribute array into its region
+        const size_t floats = count * sizeof(float);
+        const size_t colors = count * sizeof(uint32_t);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        glBufferData(GL_ARRAY_BUFFER, 3 * floats + colors, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, floats, pool.positionsX());
+        glBufferSubData(GL_ARRAY_BUFFER, floats, floats, pool.positionsY());
+        glBufferSubData(GL_ARRAY_BUFFER, 2 * floats, floats, pool.lifetimes());
+        glBufferSubData(GL_ARRAY_BUFFER, 3 * floats, colors, pool.colors());
+
+        // Offsets depend on count, so the instance attributes are re-pointed every draw
+        instanceAttribute(1, 1, GL_FLOAT, GL_FALSE, 0);
+        instanceAttribute(2, 1, GL_FLOAT, GL_FALSE, floats);
+        instanceAttribute(3, 1, GL_FLOAT, GL_FALSE, 2 * floats);
+        instanceAttribute(4, 4, GL_UNSIGNED_BYTE, GL_TRUE, 3 * floats);
+
+        glUseProgram(program);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE);  // Additive, so overlapping sparks glow
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)count);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glUseProgram(0);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+private:
+    static void instanceAttribute(GLuint index, GLint size, GLenum type, GLboolean normalized, size_t offset) {
+        glEnableVertexAttribArray(index);
+        glVertexAttribPointer(index, size, type, normalized, 0, (const void*)offset);
+        glVertexAttribDivisor(index, 1);
+    }
+
+    static constexpr const char* kVertexShader = R"(#version 330 core
+layout(location = 0) in vec2 corner;
+layout(location = 1) in float centerX;
+layout(location = 2) in float centerY;
+layout(location = 3) in float life;
+layout(location = 4) in vec4 color;
+uniform vec2 viewSize;
+out vec4 tint;
+void main() {
+    float fade = clamp(life * 2.0, 0.0, 1.0);
+    vec2 p = vec2(centerX, centerY) + corner * (1.0 + 1.5 * fade);
+    gl_Position = vec4(p.x / viewSize.x * 2.0 - 1.0, 1.0 - p.y / viewSize.y * 2.0, 0.0, 1.0);
+    tint = vec4(color.rgb, color.a * fade);
+}
+)";
+
+    static constexpr const char* kFragmentShader = R"(#version 330 core
+in vec4 tint;
+out vec4 fragColor;
+void main() {
+    fragColor = tint;
+}
+)";
+
+    GLuint program = 0;
+    GLuint vao = 0;
+    GLuint quadBuffer = 0;
+    GLuint instanceBuffer = 0;
+};
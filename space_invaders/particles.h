@@ -0,0 +1,136 @@
+#pragma once
+
+// Explosion and spark particles.
+//
+// Particles live in a fixed-capacity pool stored as one array per attribute,
+// allocated once up front. Live particles are kept packed at the front, so
+// the update is a straight 4-wide SIMD pass over the arrays followed by a
+// swap-remove of the expired ones, and the renderer uploads each array as is.
+//
+// The capacity is the hard budget. Emitting never grows the pool: each tick
+// may spawn at most kParticleSpawnBudget particles, and bursts shrink as the
+// pool fills, so heavy scenes get sparser effects instead of a slower frame.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PARTICLES_SSE2 1
+#endif
+
+constexpr size_t kMaxParticles = 16384;        // Default capacity, also the draw budget
+constexpr size_t kParticleSpawnBudget = 2048;  // New particles per tick
+
+class ParticlePool {
+public:
+    // Velocity damping per second; particles slow down as they fade
+    float drag = 2.5f;
+
+    // A capacity of 0 turns effects off, e.g. for games nobody watches
+    explicit ParticlePool(size_t capacity = kMaxParticles)
+        : x(capacity), y(capacity), vx(capacity), vy(capacity), life(capacity), color(capacity) {}
+
+    size_t size() const { return count; }
+    size_t capacity() const { return life.size(); }
+
+    const float* positionsX() const { return x.data(); }
+    const float* positionsY() const { return y.data(); }
+    const float* lifetimes() const { return life.data(); }
+    const uint32_t* colors() const { return color.data(); }  // RGBA8, red in the low byte
+
+    // Bursts `requested` particles from (px, py) at up to `speed` px/s, each
+    // living up to `maxLife` seconds. Returns how many were actually emitted.
+    size_t emit(float px, float py, size_t requested, float speed, float maxLife, float r, float g, float b) {
+        // Shrink bursts once the pool is half full, down to nothing when it is full
+        size_t free = capacity() - count;
+        size_t half = std::max<size_t>(capacity() / 2, 1);  // A one-particle pool has no half
+        if (count > capacity() / 2) requested = requested * free / half;
+        if (requested > spawnBudget) requested = spawnBudget;
+        if (requested > free) requested = free;
+        spawnBudget -= requested;
+
+        uint32_t rgba = pack(r) | pack(g) << 8 | pack(b) << 16 | 0xFF000000u;
+        for (size_t n = 0; n < requested; n++) {
+            float angle = random() * 6.2831853f;
+            float s = speed * (0.25f + 0.75f * random());
+            size_t i = count++;
+            x[i] = px;
+            y[i] = py;
+            vx[i] = std::cos(angle) * s;
+            vy[i] = std::sin(angle) * s;
+            life[i] = maxLife * (0.5f + 0.5f * random());
+            color[i] = rgba;
+        }
+        return requested;
+    }
+
+    // Integrates every particle, drops the expired ones and refills the spawn budget
+    void update(float dt) {
+        spawnBudget = kParticleSpawnBudget;
+        if (count == 0) return;
+
+        float damping = 1.0f - drag * dt;
+        if (damping < 0.0f) damping = 0.0f;
+        size_t i = 0;
+#ifdef PARTICLES_SSE2
+        const __m128 dt4 = _mm_set1_ps(dt);
+        const __m128 damping4 = _mm_set1_ps(damping);
+        for (; i + 4 <= count; i += 4) {
+            __m128 vx4 = _mm_loadu_ps(&vx[i]);
+            __m128 vy4 = _mm_loadu_ps(&vy[i]);
+            _mm_storeu_ps(&x[i], _mm_add_ps(_mm_loadu_ps(&x[i]), _mm_mul_ps(vx4, dt4)));
+            _mm_storeu_ps(&y[i], _mm_add_ps(_mm_loadu_ps(&y[i]), _mm_mul_ps(vy4, dt4)));
+            _mm_storeu_ps(&vx[i], _mm_mul_ps(vx4, damping4));
+            _mm_storeu_ps(&vy[i], _mm_mul_ps(vy4, damping4));
+            _mm_storeu_ps(&life[i], _mm_sub_ps(_mm_loadu_ps(&life[i]), dt4));
+        }
+#endif
+        for (; i < count; i++) {
+            x[i] += vx[i] * dt;
+            y[i] += vy[i] * dt;
+            vx[i] *= damping;
+            vy[i] *= damping;
+            life[i] -= dt;
+        }
+
+        // Swap-remove expired particles to keep the live ones packed
+        for (i = 0; i < count;) {
+            if (life[i] > 0.0f) {
+                i++;
+                continue;
+            }
+            count--;
+            x[i] = x[count];
+            y[i] = y[count];
+            vx[i] = vx[count];
+            vy[i] = vy[count];
+            life[i] = life[count];
+            color[i] = color[count];
+        }
+    }
+
+    void clear() { count = 0; }
+
+private:
+    static uint32_t pack(float channel) {
+        return (uint32_t)(channel <= 0.0f ? 0.0f : channel >= 1.0f ? 255.0f : channel * 255.0f + 0.5f);
+    }
+
+    // Cosmetic only, so a private xorshift keeps it off the game's random streams
+    float random() {
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 17;
+        rngState ^= rngState << 5;
+        return (rngState >> 8) * (1.0f / 16777216.0f);
+    }
+
+    std::vector<float> x, y, vx, vy, life;
+    std::vector<uint32_t> color;
+    size_t count = 0;
+    size_t spawnBudget = kParticleSpawnBudget;
+    uint32_t rngState = 0x9E3779B9u;
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+// Lightweight frame profiler.
+//
+// Phases are timed with ProfileScope and accumulated per frame; counters are
+// arbitrary per-frame values (entity counts, scheduler stats, ...); samples
+// are individual measurements that don't occur once per frame (latencies).
+// When enabled, averages over the last report interval are printed to stderr.
+// Disabled, a scope costs one branch.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+class Profiler {
+public:
+    bool enabled = false;
+    double reportInterval = 2.0;  // Seconds
+
+    // Returns the slot for a phase or counter name; names must be string literals
+    int phase(const char* name) { return slot(phaseNames, phaseCount, name); }
+    int counter(const char* name) { return slot(counterNames, counterCount, name); }
+    int sample(const char* name) { return slot(sampleNames, sampleCount, name); }
+
+    void addTime(int phaseIndex, double seconds) {
+        if (phaseIndex >= 0) phaseTotals[phaseIndex] += seconds;
+    }
+
+    void addCount(int counterIndex, double value) {
+        if (counterIndex >= 0) counterTotals[counterIndex] += value;
+    }
+
+    void addSample(int sampleIndex, double value) { addSamples(sampleIndex, 1, value, value); }
+
+    // Adds `count` samples at once, given their sum and maximum
+    void addSamples(int sampleIndex, int count, double total, double max) {
+        if (sampleIndex < 0 || count <= 0) return;
+        sampleTotals[sampleIndex] += total;
+        if (sampleCounts[sampleIndex] == 0 || max > sampleMax[sampleIndex]) sampleMax[sampleIndex] = max;
+        sampleCounts[sampleIndex] += count;
+    }
+
+    void endFrame() {
+        if (!enabled) return;
+        frames++;
+        Clock::time_point now = Clock::now();
+        double elapsed = std::chrono::duration<double>(now - windowStart).count();
+        if (elapsed < reportInterval) return;
+
+        fprintf(stderr, "\n[profile] %.1f fps |", frames / elapsed);
+        for (int i = 0; i < phaseCount; i++) {
+            fprintf(stderr, " %s %.3f ms", phaseNames[i], phaseTotals[i] * 1000.0 / frames);
+            phaseTotals[i] = 0;
+        }
+        if (counterCount) fprintf(stderr, " | per frame:");
+        for (int i = 0; i < counterCount; i++) {
+            fprintf(stderr, " %s %.1f", counterNames[i], counterTotals[i] / frames);
+            counterTotals[i] = 0;
+        }
+        for (int i = 0; i < sampleCount; i++) {
+            if (sampleCounts[i] == 0) continue;
+            fprintf(stderr, " | %s mean %.2f max %.2f (%d)", sampleNames[i], sampleTotals[i] / sampleCounts[i],
+                    sampleMax[i], sampleCounts[i]);
+            sampleTotals[i] = 0;
+            sampleCounts[i] = 0;
+        }
+        fprintf(stderr, "\n");
+        frames = 0;
+        windowStart = now;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static const int kMaxSlots = 32;
+
+    static int slot(const char** names, int& count, const char* name) {
+        for (int i = 0; i < count; i++) {
+            if (names[i] == name || strcmp(names[i], name) == 0) return i;
+        }
+        if (count == kMaxSlots) return -1;
+        names[count] = name;
+        return count++;
+    }
+
+    const char* phaseNames[kMaxSlots] = {};
+    double phaseTotals[kMaxSlots] = {};
+    int phaseCount = 0;
+
+    const char* counterNames[kMaxSlots] = {};
+    double counterTotals[kMaxSlots] = {};
+    int counterCount = 0;
+
+    const char* sampleNames[kMaxSlots] = {};
+    double sampleTotals[kMaxSlots] = {};
+    double sampleMax[kMaxSlots] = {};
+    int sampleCounts[kMaxSlots] = {};
+    int sampleCount = 0;
+
+    int frames = 0;
+    Clock::time_point windowStart = Clock::now();
+};
+
+// Adds the lifetime of the scope to a profiler phase
+class ProfileScope {
+public:
+    ProfileScope(Profiler& profiler, int phaseIndex) : profiler(profiler), phaseIndex(phaseIndex) {
+        if (profiler.enabled) start = std::chrono::steady_clock::now();
+    }
+
+    ~ProfileScope() {
+        if (profiler.enabled) {
+            profiler.addTime(phaseIndex, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+private:
+    Profiler& profiler;
+    int phaseIndex;
+    std::chrono::steady_clock::time_point start;
+};
+
+// Times startup as a sequence of steps, each measured from the end of the
+// previous one, and prints them on one line. Work done on another thread
+// can be added with its own duration.
+class StartupTimer {
+public:
+    void step(const char* name) {
+        Clock::time_point now = Clock::now();
+        add(name, std::chrono::duration<double>(now - last).count());
+        last = now;
+    }
+
+    void add(const char* name, double seconds) {
+        if (count == kMaxSteps) return;
+        names[count] = name;
+        durations[count++] = seconds;
+    }
+
+    void print() const {
+        fprintf(stderr, "[startup]");
+        for (int i = 0; i < count; i++) fprintf(stderr, " %s %.1f ms |", names[i], durations[i] * 1000.0);
+        fprintf(stderr, " total %.1f ms\n", std::chrono::duration<double>(last - start).count() * 1000.0);
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr int kMaxSteps = 16;
+
+    Clock::time_point start = Clock::now();
+    Clock::time_point last = start;
+    const char* names[kMaxSteps] = {};
+    double durations[kMaxSteps] = {};
+    int count = 0;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+// The game's sound effects, synthesized into PCM once at startup.
+//
+// Every effect is a few tenths of a second of 16-bit mono at
+// kAudioSampleRate, built from square-wave sweeps and decaying noise in the
+// spirit of the arcade original, and stored back to back in one buffer.
+// The mixer only ever reads from it, so nothing is decoded or allocated
+// while sounds play. Noise comes from a fixed LCG, so the bank is identical
+// on every run.
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+constexpr int kAudioSampleRate = 48000;
+
+enum SoundId : uint16_t {
+    kSoundShot,
+    kSoundHit,              // Armor, bunkers, the shield absorbing a bullet
+    kSoundExplosion,        // An enemy destroyed
+    kSoundPlayerExplosion,  // A life lost
+    kSoundPowerUp,
+    kSoundMarch0, kSoundMarch1, kSoundMarch2, kSoundMarch3,  // Formation steps, in turn
+    kSoundCount,
+};
+
+class SoundBank {
+public:
+    SoundBank() {
+        for (int s = 0; s < kSoundCount; s++) {
+            offsets[s] = pcm.size();
+            switch (s) {
+                case kSoundShot: sweep(0.12f, 1400.0f, 300.0f, 0.35f); break;
+                case kSoundHit: noise(0.06f, 0.4f, 0.2f); break;
+                case kSoundExplosion: noise(0.35f, 0.6f, 0.05f); break;
+                case kSoundPlayerExplosion: noise(0.9f, 0.8f, 0.02f); break;
+                case kSoundPowerUp:
+                    for (float f : {523.0f, 659.0f, 784.0f, 1047.0f}) sweep(0.07f, f, f, 0.3f);
+                    break;
+                default: {
+                    // The four descending bass notes of the march
+                    static const float notes[] = {98.0f, 87.3f, 77.8f, 73.4f};
+                    sweep(0.09f, notes[s - kSoundMarch0], notes[s - kSoundMarch0], 0.45f);
+                }
+            }
+        }
+        offsets[kSoundCount] = pcm.size();
+    }
+
+    const int16_t* samples(SoundId id) const { return pcm.data() + offsets[id]; }
+    size_t length(SoundId id) const { return offsets[id + 1] - offsets[id]; }
+
+private:
+    // Square wave gliding from one frequency to another, fading out at the end
+    void sweep(float seconds, float fromHz, float toHz, float volume) {
+        size_t count = (size_t)(seconds * kAudioSampleRate);
+        float phase = 0;
+        for (size_t i = 0; i < count; i++) {
+            float t = (float)i / count;
+            phase += (fromHz + (toHz - fromHz) * t) / kAudioSampleRate;
+            phase -= std::floor(phase);
+            float fade = t < 0.8f ? 1.0f : (1.0f - t) / 0.2f;
+            append((phase < 0.5f ? 1.0f : -1.0f) * volume * fade);
+        }
+    }
+
+    // White noise through a one-pole low-pass (smaller `smoothing` is
+    // rumblier), decaying linearly to silence
+    void noise(float seconds, float volume, float smoothing) {
+        size_t count = (size_t)(seconds * kAudioSampleRate);
+        float filtered = 0;
+        for (size_t i = 0; i < count; i++) {
+            random = random * 1664525u + 1013904223u;
+            float white = (float)(random >> 8) / 8388608.0f - 1.0f;
+            filtered += (white - filtered) * smoothing;
+            append(filtered / std::sqrt(smoothing) * volume * (1.0f - (float)i / count));
+        }
+    }
+
+    void append(float sample) {
+        sample = sample < -1.0f ? -1.0f : sample > 1.0f ? 1.0f : sample;
+        pcm.push_back((int16_t)(sample * 32767.0f));
+    }
+
+    std::vector<int16_t> pcm;
+    size_t offsets[kSoundCount + 1];
+    uint32_t random = 0x2545F491u;
+};
@@ -0,0 +1,281 @@
+#pragma once
+
+// Pixel-art sprites packed into one texture atlas.
+//
+// Every sprite is a small 1-bit drawing in this file ('#' set, '.' clear).
+// The atlas packs them on shelves into a single white-on-transparent RGBA
+// image with a pixel of padding around each, so one texture serves the
+// whole frame and sprites are colored by a per-vertex tint. Nothing here
+// touches GL; sprite_renderer.h uploads the image.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "enemy_types.h"
+
+enum SpriteId {
+    kSpriteSquid0, kSpriteSquid1,
+    kSpriteCrab0, kSpriteCrab1,
+    kSpriteOctopus0, kSpriteOctopus1,
+    kSpriteShip,
+    kSpriteShield,
+    kSpriteFrame,  // Square outline: enemy armor, power-up glow
+    kSpritePlayerBullet,
+    kSpriteEnemyBullet0, kSpriteEnemyBullet1,
+    kSpritePowerUpShield,
+    kSpritePowerUpRapidFire,
+    kSpritePowerUpMultiShot,
+    kSpritePowerUpSlowMotion,
+    kSpriteCount,
+};
+
+// First animation frame of each enemy type; the second follows it
+constexpr SpriteId kEnemySprites[] = {kSpriteSquid0, kSpriteCrab0, kSpriteOctopus0};
+static_assert(sizeof(kEnemySprites) / sizeof(kEnemySprites[0]) == kEnemyTypeCount, "every enemy type needs a sprite");
+
+struct SpriteArt {
+    SpriteId id;
+    float scale;  // World pixels per art pixel at the default size
+    int rows;
+    const char* const* art;
+};
+
+namespace sprite_art {
+constexpr const char* squid0[] = {
+    "...##...",
+    "..####..",
+    ".######.",
+    "##.##.##",
+    "########",
+    "..#..#..",
+    ".#.##.#.",
+    "#.#..#.#",
+};
+constexpr const char* squid1[] = {
+    "...##...",
+    "..####..",
+    ".######.",
+    "##.##.##",
+    "########",
+    ".#.##.#.",
+    "#......#",
+    ".#....#.",
+};
+constexpr const char* crab0[] = {
+    "..#.....#..",
+    "...#...#...",
+    "..#######..",
+    ".##.###.##.",
+    "###########",
+    "#.#######.#",
+    "#.#.....#.#",
+    "...##.##...",
+};
+constexpr const char* crab1[] = {
+    "..#.....#..",
+    "#..#...#..#",
+    "#.#######.#",
+    "###.###.###",
+    "###########",
+    ".#########.",
+    "..#.....#..",
+    ".#.......#.",
+};
+constexpr const char* octopus0[] = {
+    "....####....",
+    ".##########.",
+    "############",
+    "###..##..###",
+    "############",
+    "...##..##...",
+    "..##.##.##..",
+    "##........##",
+};
+constexpr const char* octopus1[] = {
+    "....####....",
+    ".##########.",
+    "############",
+    "###..##..###",
+    "############",
+    "..###..###..",
+    ".##..##..##.",
+    "..##....##..",
+};
+constexpr const char* ship[] = {
+    "......#......",
+    ".....###.....",
+    ".....###.....",
+    ".###########.",
+    "#############",
+    "#############",
+    "#############",
+    "#############",
+};
+constexpr const char* shield[] = {
+    ".....#####.....",
+    "...##.....##...",
+    "..#.........#..",
+    ".#...........#.",
+    "#.............#",
+    "#.............#",
+    "#.............#",
+    ".#...........#.",
+    "..#.........#..",
+    "...##.....##...",
+    ".....#####.....",
+};
+constexpr const char* frame[] = {
+    "############",
+    "#..........#",
+    "#..........#",
+    "#..........#",
+    "#..........#",
+    "#..........#",
+    "#..........#",
+    "#..........#",
+    "#..........#",
+    "#..........#",
+    "#..........#",
+    "############",
+};
+constexpr const char* playerBullet[] = {"#", "#", "#", "#"};
+constexpr const char* enemyBullet0[] = {".#.", "#..", ".#.", "..#", ".#.", "#..", ".#.", "..#"};
+constexpr const char* enemyBullet1[] = {".#.", "..#", ".#.", "#..", ".#.", "..#", ".#.", "#.."};
+constexpr const char* powerUpShield[] = {
+    ".#####.",
+    "#######",
+    "#######",
+    "#######",
+    ".#####.",
+    "..###..",
+    "...#...",
+};
+constexpr const char* powerUpRapidFire[] = {
+    "...#...",
+    "..#.#..",
+    ".#...#.",
+    "...#...",
+    "..#.#..",
+    ".#...#.",
+    "#.....#",
+};
+constexpr const char* powerUpMultiShot[] = {
+    "#..#..#",
+    "#..#..#",
+    ".#.#.#.",
+    ".#.#.#.",
+    "..###..",
+    "...#...",
+    "...#...",
+};
+constexpr const char* powerUpSlowMotion[] = {
+    "#######",
+    ".#...#.",
+    "..#.#..",
+    "...#...",
+    "..#.#..",
+    ".#...#.",
+    "#######",
+};
+}  // namespace sprite_art
+
+#define SPRITE_ART(id, scale, art) {id, scale, (int)(sizeof(sprite_art::art) / sizeof(sprite_art::art[0])), sprite_art::art}
+
+// Scales give enemies a 30 px wide body like their collision box, the ship
+// its 40 px, and bullets and power-ups about their old sizes
+constexpr SpriteArt kSpriteArt[kSpriteCount] = {
+    SPRITE_ART(kSpriteSquid0, 3.0f, squid0),
+    SPRITE_ART(kSpriteSquid1, 3.0f, squid1),
+    SPRITE_ART(kSpriteCrab0, 2.75f, crab0),
+    SPRITE_ART(kSpriteCrab1, 2.75f, crab1),
+    SPRITE_ART(kSpriteOctopus0, 2.5f, octopus0),
+    SPRITE_ART(kSpriteOctopus1, 2.5f, octopus1),
+    SPRITE_ART(kSpriteShip, 3.0f, ship),
+    SPRITE_ART(kSpriteShield, 4.0f, shield),
+    SPRITE_ART(kSpriteFrame, 2.0f, frame),
+    SPRITE_ART(kSpritePlayerBullet, 4.0f, playerBullet),
+    SPRITE_ART(kSpriteEnemyBullet0, 2.0f, enemyBullet0),
+    SPRITE_ART(kSpriteEnemyBullet1, 2.0f, enemyBullet1),
+    SPRITE_ART(kSpritePowerUpShield, 2.0f, powerUpShield),
+    SPRITE_ART(kSpritePowerUpRapidFire, 2.0f, powerUpRapidFire),
+    SPRITE_ART(kSpritePowerUpMultiShot, 2.0f, powerUpMultiShot),
+    SPRITE_ART(kSpritePowerUpSlowMotion, 2.0f, powerUpSlowMotion),
+};
+
+#undef SPRITE_ART
+
+constexpr bool spriteArtInOrder() {
+    for (int s = 0; s < kSpriteCount; s++) {
+        if (kSpriteArt[s].id != s) return false;
+    }
+    return true;
+}
+static_assert(spriteArtInOrder(), "kSpriteArt must list every sprite in SpriteId order");
+
+constexpr int spriteArtWidth(const SpriteArt& art) {
+    int width = 0;
+    while (art.art[0][width]) width++;
+    return width;
+}
+
+// Where shelf packing in table order puts each sprite, padding included
+struct SpriteLayout {
+    int x[kSpriteCount] = {};
+    int y[kSpriteCount] = {};
+    int width = 0, height = 0;  // Extent of the packed sprites
+};
+
+constexpr SpriteLayout packSprites(int atlasSize) {
+    SpriteLayout layout;
+    int x = 0, y = 0, shelfHeight = 0;
+    for (int s = 0; s < kSpriteCount; s++) {
+        int w = spriteArtWidth(kSpriteArt[s]) + 2, h = kSpriteArt[s].rows + 2;
+        if (x + w > atlasSize) {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+        layout.x[s] = x;
+        layout.y[s] = y;
+        x += w;
+        if (h > shelfHeight) shelfHeight = h;
+        if (x > layout.width) layout.width = x;
+        if (y + h > layout.height) layout.height = y + h;
+    }
+    return layout;
+}
+
+struct SpriteRect {
+    float u0, v0, u1, v1;  // Texture coordinates of the art, excluding padding
+    float width, height;   // Default size in world pixels
+};
+
+class SpriteAtlas {
+public:
+    static constexpr int kSize = 64;  // Square atlas, in pixels
+    static constexpr SpriteLayout kLayout = packSprites(kSize);
+    static_assert(kLayout.width <= kSize && kLayout.height <= kSize, "sprites no longer fit the atlas; grow kSize");
+
+    SpriteAtlas() : image((size_t)kSize * kSize, 0) {
+        for (int s = 0; s < kSpriteCount; s++) {
+            const SpriteArt& art = kSpriteArt[s];
+            int x = kLayout.x[s] + 1, y = kLayout.y[s] + 1;  // Inside the padding
+            int w = spriteArtWidth(art), h = art.rows;
+            for (int row = 0; row < h; row++) {
+                for (int col = 0; col < w; col++) {
+                    if (art.art[row][col] == '#') image[(size_t)(y + row) * kSize + x + col] = 0xFFFFFFFFu;
+                }
+            }
+            rects[s] = SpriteRect{(float)x / kSize, (float)y / kSize, (float)(x + w) / kSize, (float)(y + h) / kSize,
+                                  w * art.scale, h * art.scale};
+        }
+    }
+
+    const SpriteRect& rect(SpriteId id) const { return rects[id]; }
+    const uint32_t* pixels() const { return image.data(); }  // kSize x kSize RGBA8, top row first
+
+private:
+    std::vector<uint32_t> image;
+    SpriteRect rects[kSpriteCount];
+};
@@ -0,0 +1,171 @@
+#pragma once
+
+// Batched sprite drawing from one texture atlas.
+//
+// A frame's sprites are appended as tinted quads to a vertex array on the
+// CPU, then uploaded into one streaming buffer and drawn with a single
+// glDrawElements against a static index buffer, with the atlas as the only
+// bound texture. The vertex array is sized once, so adding sprites never
+// allocates; a frame with more than kMaxSprites sprites is drawn in several
+// batches. Like the particle renderer, the shader maps game coordinates
+// (640x480, y down) to clip space itself. Requires a GL 3.3 context with
+// its functions loaded.
+
+#include <glad/gl.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gl_shader.h"
+#include "sprite_atlas.h"
+
+// RGBA8 tint, red in the low byte like particle colors
+inline uint32_t spriteColor(float r, float g, float b, float a = 1.0f) {
+    auto channel = [](float c) { return (uint32_t)(c <= 0.0f ? 0.0f : c >= 1.0f ? 255.0f : c * 255.0f + 0.5f); };
+    return channel(r) | channel(g) << 8 | channel(b) << 16 | channel(a) << 24;
+}
+
+class SpriteRenderer {
+public:
+    static constexpr size_t kMaxSprites = 8192;  // Per batch
+
+    SpriteRenderer(float viewWidth, float viewHeight) {
+        vertices.reserve(kMaxSprites * 4);
+
+        program = buildProgram("Sprite", kVertexShader, kFragmentShader);
+        if (!program) return;
+        glUseProgram(program);
+        glUniform2f(glGetUniformLocation(program, "viewSize"), viewWidth, viewHeight);
+        glUniform1i(glGetUniformLocation(program, "atlas"), 0);
+        glUseProgram(0);
+
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, SpriteAtlas::kSize, SpriteAtlas::kSize, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                     atlas.pixels());
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        // Two triangles per quad, the same for every batch
+        std::vector<GLuint> indices(kMaxSprites * 6);
+        for (GLuint q = 0; q < kMaxSprites; q++) {
+            const GLuint corners[6] = {0, 1, 2, 2, 1, 3};
+            for (int k = 0; k < 6; k++) indices[q * 6 + k] = q * 4 + corners[k];
+        }
+
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vertexBuffer);
+        glGenBuffers(1, &indexBuffer);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, kMaxSprites * 4 * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, x));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (const void*)offsetof(Vertex, u));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (const void*)offsetof(Vertex, color));
+        glBindVertexArray(0);  // Unbind the VAO first so it keeps its index buffer
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    ~SpriteRenderer() {
+        glDeleteBuffers(1, &indexBuffer);
+        glDeleteBuffers(1, &vertexBuffer);
+        glDeleteVertexArrays(1, &vao);
+        glDeleteTextures(1, &texture);
+        glDeleteProgram(program);
+    }
+
+    SpriteRenderer(const SpriteRenderer&) = delete;
+    SpriteRenderer& operator=(const SpriteRenderer&) = delete;
+
+    // Queues a sprite centered on (x, y) at its default size
+    void add(SpriteId id, float x, float y, uint32_t color) {
+        const SpriteRect& r = atlas.rect(id);
+        add(id, x, y, r.width, r.height, color);
+    }
+
+    // Queues a sprite centered on (x, y), stretched to width x height
+    void add(SpriteId id, float x, float y, float width, float height, uint32_t color) {
+        if (vertices.size() == kMaxSprites * 4) flush();
+        const SpriteRect& r = atlas.rect(id);
+        float x0 = x - width * 0.5f, x1 = x + width * 0.5f;
+        float y0 = y - height * 0.5f, y1 = y + height * 0.5f;
+        vertices.push_back({x0, y0, r.u0, r.v0, color});
+        vertices.push_back({x1, y0, r.u1, r.v0, color});
+        vertices.push_back({x0, y1, r.u0, r.v1, color});
+        vertices.push_back({x1, y1, r.u1, r.v1, color});
+    }
+
+    // Draws everything queued since the last flush in one call
+    void flush() {
+        size_t quads = vertices.size() / 4;
+        if (!program || quads == 0) {
+            vertices.clear();
+            return;
+        }
+
+        // Orphan the previous batch's storage rather than wait for the GPU to finish with it
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, kMaxSprites * 4 * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
+
+        glUseProgram(program);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glDrawElements(GL_TRIANGLES, (GLsizei)(quads * 6), GL_UNSIGNED_INT, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glUseProgram(0);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        vertices.clear();
+    }
+
+private:
+    struct Vertex {
+        float x, y;
+        float u, v;
+        uint32_t color;
+    };
+
+    static constexpr const char* kVertexShader = R"(#version 330 core
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec2 uv;
+layout(location = 2) in vec4 color;
+uniform vec2 viewSize;
+out vec2 texCoord;
+out vec4 tint;
+void main() {
+    gl_Position = vec4(position.x / viewSize.x * 2.0 - 1.0, 1.0 - position.y / viewSize.y * 2.0, 0.0, 1.0);
+    texCoord = uv;
+    tint = color;
+}
+)";
+
+    static constexpr const char* kFragmentShader = R"(#version 330 core
+in vec2 texCoord;
+in vec4 tint;
+uniform sampler2D atlas;
+out vec4 fragColor;
+void main() {
+    fragColor = texture(atlas, texCoord) * tint;
+}
+)";
+
+    SpriteAtlas atlas;
+    std::vector<Vertex> vertices;
+    GLuint program = 0;
+    GLuint texture = 0;
+    GLuint vao = 0;
+    GLuint vertexBuffer = 0;
+    GLuint indexBuffer = 0;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+// Lock-free single-producer single-consumer ring of fixed capacity.
+//
+// Exactly one thread pushes and one other thread pops; neither side ever
+// blocks, locks or allocates. Head and tail are free-running counters on
+// their own cache lines. Each side keeps a private copy of the other's
+// counter and only reloads it when the ring looks full (or empty), so a
+// push or pop in steady state writes one shared line and reads none.
+
+#include <atomic>
+#include <cstddef>
+
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+public:
+    // Producer: false, and nothing stored, if the ring is full
+    bool push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - cachedHead == Capacity) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (t - cachedHead == Capacity) return false;
+        }
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: the oldest item, left in place, or null if the ring is empty
+    const T* front() {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h == cachedTail) return nullptr;
+        }
+        return &items[h & (Capacity - 1)];
+    }
+
+    // Consumer: drops the item front() returned
+    void popFront() { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+private:
+    alignas(64) std::atomic<size_t> head{0};  // Written by the consumer
+    size_t cachedTail = 0;                    // Consumer's copy of tail
+    alignas(64) std::atomic<size_t> tail{0};  // Written by the producer
+    size_t cachedHead = 0;                    // Producer's copy of head
+    alignas(64) T items[Capacity];
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+// Parallax starfield behind the game, animated entirely on the GPU.
+//
+// Each star's starting position, layer speed and brightness go into a
+// static vertex buffer once at startup. Every frame costs one uniform and
+// one glDrawArrays of points: the vertex shader scrolls each star down by
+// speed * time, wrapping at the bottom of the screen, and twinkles it from
+// its vertex id. Far layers are dimmer, smaller and slower. Points of one
+// or two pixels keep fill cost negligible even on software GL. Requires a
+// GL 3.3 context with its functions loaded.
+
+#include <glad/gl.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gl_shader.h"
+
+struct StarLayer {
+    int count;
+    float speed;  // Pixels per second; a whole multiple of 480 / kStarfieldPeriod
+    float brightness;
+    float size;   // Point size in pixels
+};
+
+// Far to near
+constexpr StarLayer kStarLayers[] = {
+    {220, 5.0f, 0.35f, 1.0f},
+    {110, 15.0f, 0.6f, 1.0f},
+    {40, 40.0f, 1.0f, 2.0f},
+};
+
+// Every layer scrolls a whole number of screens in this many seconds, so
+// callers can wrap time to it and keep the shader's float math precise
+constexpr double kStarfieldPeriod = 96.0;
+
+class StarfieldRenderer {
+public:
+    StarfieldRenderer(float viewWidth, float viewHeight) {
+        program = buildProgram("Starfield", kVertexShader, kFragmentShader);
+        if (!program) return;
+        glUseProgram(program);
+        glUniform2f(glGetUniformLocation(program, "viewSize"), viewWidth, viewHeight);
+        timeLocation = glGetUniformLocation(program, "time");
+        glUseProgram(0);
+
+        // Stars are scattered by a fixed LCG so the sky is the same every run
+        std::vector<Star> stars;
+        uint32_t state = 12345;
+        auto next = [&state] {
+            state = state * 1664525u + 1013904223u;
+            return (state >> 8) / 16777216.0f;
+        };
+        for (const StarLayer& layer : kStarLayers) {
+            for (int i = 0; i < layer.count; i++) {
+                float x = next() * viewWidth, y = next() * viewHeight;
+                stars.push_back({x, y, layer.speed, layer.brightness * (0.7f + 0.3f * next()), layer.size});
+            }
+        }
+        starCount = (GLsizei)stars.size();
+
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &vertexBuffer);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+        glBufferData(GL_ARRAY_BUFFER, stars.size() * sizeof(Star), stars.data(), GL_STATIC_DRAW);
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Star), (const void*)offsetof(Star, x));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(Star), (const void*)offsetof(Star, size));
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    ~StarfieldRenderer() {
+        glDeleteBuffers(1, &vertexBuffer);
+        glDeleteVertexArrays(1, &vao);
+        glDeleteProgram(program);
+    }
+
+    StarfieldRenderer(const StarfieldRenderer&) = delete;
+    StarfieldRenderer& operator=(const StarfieldRenderer&) = delete;
+
+    // `time` in seconds, best wrapped to [0, kStarfieldPeriod)
+    void draw(float time) {
+        if (!program) return;
+        glUseProgram(program);
+        glUniform1f(timeLocation, time);
+        glEnable(GL_PROGRAM_POINT_SIZE);
+        glBindVertexArray(vao);
+        glDrawArrays(GL_POINTS, 0, starCount);
+        glBindVertexArray(0);
+        glDisable(GL_PROGRAM_POINT_SIZE);
+        glUseProgram(0);
+    }
+
+private:
+    struct Star {
+        float x, y;
+        float speed;
+        float brightness;
+        float size;
+    };
+
+    static constexpr const char* kVertexShader = R"(#version 330 core
+layout(location = 0) in vec4 star;  // x, y, speed, brightness
+layout(location = 1) in float size;
+uniform vec2 viewSize;
+uniform float time;
+out float glow;
+void main() {
+    vec2 position = vec2(star.x, mod(star.y + star.z * time, viewSize.y));
+    gl_Position = vec4(position.x / viewSize.x * 2.0 - 1.0, 1.0 - position.y / viewSize.y * 2.0, 0.0, 1.0);
+    gl_PointSize = size;
+    float phase = float(gl_VertexID) * 2.399;  // Golden angle spreads the twinkle phases
+    glow = star.w * (0.8 + 0.2 * sin(time * 3.14159265 + phase));  // 2 s period divides the wrap
+}
+)";
+
+    static constexpr const char* kFragmentShader = R"(#version 330 core
+in float glow;
+out vec4 fragColor;
+void main() {
+    fragColor = vec4(vec3(glow), 1.0);
+}
+)";
+
+    GLuint program = 0;
+    GLuint vao = 0;
+    GLuint vertexBuffer = 0;
+    GLint timeLocation = -1;
+    GLsizei starCount = 0;
+};
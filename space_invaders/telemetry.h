@@ -0,0 +1,245 @@
+#pragma once
+
+// Binary per-frame telemetry in a memory-mapped ring file.
+//
+// The file is a small header followed by a fixed number of fixed-size
+// records. Writing a frame is a struct copy into the mapping plus release
+// stores of its sequence and the write index: no system calls, no
+// allocation. The pages belong to the file, so the log survives the game
+// crashing; the kernel writes them back on its own schedule. Logging is off
+// unless --telemetry names a file. space_invaders_telemetry reads and
+// summarizes a log, also while the game is running.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+enum TelemetryFlags : uint8_t {
+    kTelemetryPaused = 1 << 0,
+    kTelemetryGameOver = 1 << 1,
+    kTelemetryShield = 1 << 2,
+    kTelemetryRapidFire = 1 << 3,
+    kTelemetryMultiShot = 1 << 4,
+    kTelemetrySlowMotion = 1 << 5,
+};
+
+struct TelemetryRecord {
+    uint64_t frame;
+    double time;  // Seconds since the log was opened
+    float frameMs, updateMs, renderMs;
+    uint16_t ticks;  // Simulation ticks run this frame
+    uint8_t speed;   // Fast-forward setting; 0 is max
+    uint8_t flags;   // TelemetryFlags
+    uint32_t enemies, playerBullets, enemyBullets, powerUps, particles;
+    uint32_t allocations, allocBytes;  // Heap activity this frame
+    int32_t wave, score, lives;
+};
+
+static_assert(std::is_trivially_copyable<TelemetryRecord>::value, "records are copied into the mapping as bytes");
+
+// A record and the write that produced it. The sequence is index + 1 once
+// the record is complete and 0 while it is being written, so a reader that
+// sees the same sequence before and after copying got a whole record.
+struct TelemetrySlot {
+    std::atomic<uint64_t> sequence;
+    TelemetryRecord record;
+};
+
+struct TelemetryHeader {
+    char magic[8];  // "SITELEM"
+    uint32_t version;
+    uint32_t recordSize;               // sizeof(TelemetrySlot)
+    uint64_t capacity;                 // Records in the ring
+    std::atomic<uint64_t> writeIndex;  // Records written so far; the newest is at (writeIndex - 1) % capacity
+};
+
+static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t) && std::atomic<uint64_t>::is_always_lock_free,
+              "the write index and sequences are shared through the file");
+
+constexpr uint32_t kTelemetryVersion = 2;
+constexpr size_t kTelemetryHeaderSize = 64;  // Records start here
+static_assert(sizeof(TelemetryHeader) <= kTelemetryHeaderSize, "header must fit before the records");
+
+// A mapped telemetry file, either created for writing or opened read-only.
+// A writer holds an exclusive lock on the file until it closes, so a second
+// game can't reset a log that is still being written; readers take no lock.
+class TelemetryFile {
+public:
+    ~TelemetryFile() { close(); }
+
+    // Creates (or resets) a log holding `capacity` records; fails if another
+    // process is writing to it
+    bool create(const char* path, uint64_t capacity) {
+        if (!map(path, kTelemetryHeaderSize + capacity * sizeof(TelemetrySlot), true)) return false;
+        TelemetryHeader* h = header();
+        memcpy(h->magic, "SITELEM", 8);
+        h->version = kTelemetryVersion;
+        h->recordSize = sizeof(TelemetrySlot);
+        h->capacity = capacity;
+        h->writeIndex.store(0, std::memory_order_relaxed);
+        // Fault the pages in now, not mid-game, and forget any older log's records
+        for (uint64_t i = 0; i < capacity; i++) slots()[i].sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return true;
+    }
+
+    bool openForReading(const char* path) {
+        if (!map(path, 0, false)) return false;
+        const TelemetryHeader* h = header();
+        if (size < kTelemetryHeaderSize || memcmp(h->magic, "SITELEM", 8) != 0 || h->version != kTelemetryVersion ||
+            h->recordSize != sizeof(TelemetrySlot) ||
+            size < kTelemetryHeaderSize + h->capacity * sizeof(TelemetrySlot)) {
+            fprintf(stderr, "%s is not a telemetry log this build can read\n", path);
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+
+    // Hot path: one record copy and three stores. The file lock makes this
+    // process the only writer, so the index needs no read-modify-write.
+    void write(const TelemetryRecord& record) {
+        if (!base) return;
+        TelemetryHeader* h = header();
+        uint64_t index = h->writeIndex.load(std::memory_order_relaxed);
+        TelemetrySlot& slot = slots()[index % h->capacity];
+        slot.sequence.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&slot.record, &record, sizeof(TelemetryRecord));
+        slot.sequence.store(index + 1, std::memory_order_release);
+        h->writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    uint64_t written() const { return header()->writeIndex.load(std::memory_order_acquire); }
+    uint64_t capacity() const { return header()->capacity; }
+
+    // Index of the oldest record still in the ring, given a written() count
+    uint64_t oldest(uint64_t written) const { return written > capacity() ? written - capacity() : 0; }
+
+    // Copies record `index` (counting from the first ever written); false if
+    // it was overwritten or is being written right now
+    bool read(uint64_t index, TelemetryRecord& out) const {
+        const TelemetrySlot& slot = slots()[index % capacity()];
+        if (slot.sequence.load(std::memory_order_acquire) != index + 1) return false;
+        memcpy(&out, &slot.record, sizeof(TelemetryRecord));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return slot.sequence.load(std::memory_order_relaxed) == index + 1;
+    }
+
+    void close() {
+        if (!base) return;
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+        CloseHandle(mapping);
+        CloseHandle(file);
+#else
+        munmap(base, size);
+        if (lockedFile >= 0) ::close(lockedFile);  // Releases the writer's lock
+        lockedFile = -1;
+#endif
+        base = nullptr;
+    }
+
+private:
+    TelemetryHeader* header() const { return reinterpret_cast<TelemetryHeader*>(base); }
+    TelemetrySlot* slots() const { return reinterpret_cast<TelemetrySlot*>(base + kTelemetryHeaderSize); }
+
+    // Maps the whole file; when writing, locks it and sizes it to `bytes` first
+    bool map(const char* path, size_t bytes, bool writable) {
+        close();
+#ifdef _WIN32
+        // A writer shares the file for reading only, so a second writer fails
+        // to open it. The file is resized rather than recreated, which Windows
+        // refuses while a reader has it mapped.
+        file = CreateFileA(path, writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                           writable ? FILE_SHARE_READ : FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                           writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            if (GetLastError() == ERROR_SHARING_VIOLATION) {
+                fprintf(stderr, "Telemetry log %s is in use by another game\n", path);
+            } else {
+                fprintf(stderr, "Could not open telemetry log %s\n", path);
+            }
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        fileSize.QuadPart = (LONGLONG)bytes;
+        if (!writable) GetFileSizeEx(file, &fileSize);
+        mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                     (DWORD)(fileSize.QuadPart >> 32), (DWORD)fileSize.QuadPart, nullptr);
+        void* view = mapping ? MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view) {
+            fprintf(stderr, "Could not map telemetry log %s\n", path);
+            if (mapping) CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        size = (size_t)fileSize.QuadPart;
+#else
+        // No O_TRUNC: the file is only resized once the lock shows nobody else is writing it
+        int fd = ::open(path, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+        if (fd < 0) {
+            fprintf(stderr, "Could not open telemetry log %s\n", path);
+            return false;
+        }
+        if (writable && flock(fd, LOCK_EX | LOCK_NB) != 0) {
+            if (errno == EWOULDBLOCK) {
+                fprintf(stderr, "Telemetry log %s is in use by another game\n", path);
+            } else {
+                fprintf(stderr, "Could not lock telemetry log %s\n", path);
+            }
+            ::close(fd);
+            return false;
+        }
+        struct stat info;
+        if (writable ? ftruncate(fd, (off_t)bytes) != 0 : fstat(fd, &info) != 0) {
+            fprintf(stderr, "Could not size telemetry log %s\n", path);
+            ::close(fd);
+            return false;
+        }
+        size = writable ? bytes : (size_t)info.st_size;
+        void* view = size ? mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0)
+                          : MAP_FAILED;
+        if (view == MAP_FAILED) {
+            fprintf(stderr, "Could not map telemetry log %s\n", path);
+            ::close(fd);
+            return false;
+        }
+        if (writable) lockedFile = fd;  // Held open for the lock
+        else ::close(fd);               // The mapping keeps the file
+#endif
+        base = static_cast<unsigned char*>(view);
+        return true;
+    }
+
+    unsigned char* base = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int lockedFile = -1;
+#endif
+};
@@ -0,0 +1,166 @@
+// Prints summaries of a telemetry log written by the game (see telemetry.h).
+// The log is mapped read-only, so it can be inspected while the game runs
+// or after it crashed.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "telemetry.h"
+
+static const char* kUsage =
+    "Usage: %s <telemetry file> [options]\n"
+    "  --tail <n>   Also list the last n frames\n"
+    "  --follow     Show a live status line while the game runs (Ctrl+C to stop)\n";
+
+static double percentile(std::vector<float>& values, double p) {
+    size_t k = (size_t)(p * (values.size() - 1));
+    std::nth_element(values.begin(), values.begin() + k, values.end());
+    return values[k];
+}
+
+static void printFlags(uint8_t flags) {
+    if (flags & kTelemetryPaused) printf(" paused");
+    if (flags & kTelemetryGameOver) printf(" game-over");
+    if (flags & kTelemetryShield) printf(" shield");
+    if (flags & kTelemetryRapidFire) printf(" rapid-fire");
+    if (flags & kTelemetryMultiShot) printf(" multi-shot");
+    if (flags & kTelemetrySlowMotion) printf(" slow-motion");
+}
+
+// Copies out every complete record still in the ring, oldest first. Ones
+// the game overwrote or was writing during the copy are left out; returns
+// how many that was.
+static uint64_t snapshot(const TelemetryFile& log, uint64_t written, std::vector<TelemetryRecord>& records) {
+    records.clear();
+    records.reserve(written - log.oldest(written));
+    TelemetryRecord r;
+    for (uint64_t index = log.oldest(written); index < written; index++) {
+        if (log.read(index, r)) records.push_back(r);
+    }
+    return written - log.oldest(written) - records.size();
+}
+
+static void printSummary(const TelemetryFile& log, const std::vector<TelemetryRecord>& records, uint64_t written,
+                         uint64_t skipped) {
+    uint64_t count = records.size();
+    printf("%llu frames logged, last %llu kept (ring of %llu)", (unsigned long long)written,
+           (unsigned long long)count, (unsigned long long)log.capacity());
+    if (skipped) printf(", %llu skipped mid-write", (unsigned long long)skipped);
+    printf("\n");
+    if (count == 0) return;
+
+    std::vector<float> frameMs;
+    frameMs.reserve(count);
+    double update = 0, render = 0, ticks = 0, allocations = 0, allocBytes = 0;
+    uint64_t allocatingFrames = 0, pausedFrames = 0;
+    uint32_t maxEnemyBullets = 0, maxPlayerBullets = 0, maxParticles = 0;
+    for (const TelemetryRecord& r : records) {
+        frameMs.push_back(r.frameMs);
+        update += r.updateMs;
+        render += r.renderMs;
+        ticks += r.ticks;
+        allocations += r.allocations;
+        allocBytes += r.allocBytes;
+        if (r.allocations) allocatingFrames++;
+        if (r.flags & kTelemetryPaused) pausedFrames++;
+        maxEnemyBullets = std::max(maxEnemyBullets, r.enemyBullets);
+        maxPlayerBullets = std::max(maxPlayerBullets, r.playerBullets);
+        maxParticles = std::max(maxParticles, r.particles);
+    }
+
+    const TelemetryRecord& first = records.front();
+    const TelemetryRecord& last = records.back();
+    double mean = 0;
+    for (float ms : frameMs) mean += ms;
+    mean /= count;
+    printf("Span:        %.1f s (frames %llu-%llu)\n", last.time - first.time, (unsigned long long)first.frame,
+           (unsigned long long)last.frame);
+    printf("Frame time:  mean %.2f ms | p50 %.2f | p95 %.2f | p99 %.2f | max %.2f\n", mean,
+           percentile(frameMs, 0.50), percentile(frameMs, 0.95), percentile(frameMs, 0.99),
+           *std::max_element(frameMs.begin(), frameMs.end()));
+    printf("Split:       update %.3f ms | render %.3f ms | %.2f ticks per frame\n", update / count, render / count,
+           ticks / count);
+    printf("Heap:        %.2f allocations, %.0f bytes per frame | %llu of %llu frames allocated\n",
+           allocations / count, allocBytes / count, (unsigned long long)allocatingFrames, (unsigned long long)count);
+    printf("Peaks:       %u player bullets | %u enemy bullets | %u particles\n", maxPlayerBullets, maxEnemyBullets,
+           maxParticles);
+    printf("Paused:      %.1f%% of frames\n", 100.0 * pausedFrames / count);
+    printf("Last frame:  wave %d | score %d | lives %d | enemies %u |", last.wave, last.score, last.lives, last.enemies);
+    printFlags(last.flags);
+    printf("\n");
+}
+
+static void printTail(const std::vector<TelemetryRecord>& records, uint64_t n) {
+    uint64_t count = records.size();
+    n = std::min(n, count);
+    printf("\n%8s %9s %7s %7s %7s %5s %7s %7s %7s %6s %6s %8s  flags\n", "frame", "time", "frame", "update", "render",
+           "ticks", "enemies", "p.bull", "e.bull", "parts", "allocs", "score");
+    for (uint64_t i = count - n; i < count; i++) {
+        const TelemetryRecord& r = records[i];
+        printf("%8llu %9.3f %7.2f %7.3f %7.3f %5u %7u %7u %7u %6u %6u %8d ", (unsigned long long)r.frame, r.time,
+               r.frameMs, r.updateMs, r.renderMs, r.ticks, r.enemies, r.playerBullets, r.enemyBullets, r.particles,
+               r.allocations, r.score);
+        printFlags(r.flags);
+        printf("\n");
+    }
+}
+
+// The status line the game used to print itself
+static void follow(const TelemetryFile& log) {
+    uint64_t seen = 0;
+    for (;;) {
+        uint64_t written = log.written();
+        TelemetryRecord r;
+        if (written != seen && written > 0 && log.read(written - 1, r)) {
+            seen = written;
+            printf("\rWave: %d | Score: %d | Lives: %d | Enemies: %u", r.wave, r.score, r.lives, r.enemies);
+            printf(r.speed == 1 ? "          " : " | >> %-3s", r.speed ? (r.speed == 2 ? "2x" : "8x") : "max");
+            printf(r.flags & kTelemetryPaused ? " [PAUSED]" : "         ");
+            fflush(stdout);
+            if (r.flags & kTelemetryGameOver) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    printf("\n");
+}
+
+int main(int argc, char* argv[])
+{
+    const char* path = nullptr;
+    long tail = 0;
+    bool live = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tail") == 0 && i + 1 < argc) {
+            tail = atol(argv[++i]);
+        } else if (strcmp(argv[i], "--follow") == 0) {
+            live = true;
+        } else if (!path && argv[i][0] != '-') {
+            path = argv[i];
+        } else {
+            fprintf(stderr, kUsage, argv[0]);
+            return -1;
+        }
+    }
+    if (!path) {
+        fprintf(stderr, kUsage, argv[0]);
+        return -1;
+    }
+
+    TelemetryFile log;
+    if (!log.openForReading(path)) return 1;
+    if (live) {
+        follow(log);
+        return 0;
+    }
+    std::vector<TelemetryRecord> records;
+    uint64_t written = log.written();
+    uint64_t skipped = snapshot(log, written, records);
+    printSummary(log, records, written, skipped);
+    if (tail > 0) printTail(records, (uint64_t)tail);
+    return 0;
+}